@@ -0,0 +1,2 @@
+1000
+Processor!
@@ -0,0 +1,5 @@
+1000
+0.015
+-25
+0
+Processor!
@@ -0,0 +1,4 @@
+Pure calls: 1 hits, 64 misses
+10000
+10000
+Processor!
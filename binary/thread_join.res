@@ -0,0 +1 @@
+Processor!
@@ -29,8 +29,10 @@
 #include <string.h>
 #include "libs/text.hpp"
 #include "libs/parser.hpp"
-#include "console/asm_func_list.hpp"
+#include "libs/memory.hpp"
+#include "libs/fixed.hpp"
 #include "command.hpp"
+#include "console/asm_func_list.hpp"
 #include "assert.hpp"
 
 
@@ -49,9 +51,17 @@ typedef size_t hash_t;
 #include "hash.hpp"
 
 
+/// Operands of register form commands
+typedef enum {
+    OPERAND_SRC   = 1, ///< Register or constant after destination register
+    OPERAND_LABEL = 2, ///< Jump label after all operands
+    OPERAND_STACK = 4, ///< Command takes operands from stack if no register given
+} OPERANDS;
+
+
 /// Contains information about label
 typedef struct {
-    arg_t value = 0;
+    long long value = 0;    ///< Offset for labels, constant in cell encoding for variables
     String name = {};
     hash_t hash = 0;
 } Label;
@@ -62,8 +72,12 @@ typedef struct {
     cmd_t *code = nullptr;      ///< Operation code 
     size_t count = 0;           ///< Operation count
     cmd_t *ip = nullptr;        ///< Current operation
+    cmd_t *cmd = nullptr;       ///< First byte of current command
     Label *labels = nullptr;    ///< Process labels
     int labels_count = 0;       ///< Labels count
+    size_t ram_size = RAM_SIZE; ///< Required RAM size in cells
+    Fixed fixed = {};           ///< Fixed point format of immediate values
+    int cell = CELL_FIXED32;    ///< Cell type of immediate values (one of CELL_TYPE)
 } Process;
 
 
@@ -93,7 +107,7 @@ int write_file(int file, Process *process);
  * \param [in] label_name Label with this name will be searched
  * \return Actual value or -1 if label not found
 */
-int get_label_value(Process *process, String *label);
+long long get_label_value(Process *process, String *label);
 
 
 /**
@@ -108,12 +122,23 @@ String get_token(char *origin, const char *solo, const char *extra);
 
 
 /**
- * \brief Converts string in number
+ * \brief Converts string in fixed point number
  * \param [in] str String to converts
  * \param [in] value Expected integer value
- * \return Non zero value means unconvertable string
+ * \param [in] fixed Fixed point format
+ * \return Non zero value means successful conversion
 */
-int str_to_int(String *str, int *value);
+int str_to_int(String *str, int *value, const Fixed *fixed);
+
+
+/**
+ * \brief Converts string in number of process cell type
+ * \param [in]  str String to convert
+ * \param [out] value Number bits (32 bit fixed point numbers are sign extended)
+ * \param [in]  process Process with cell type and fixed point format
+ * \return Non zero value means successful conversion
+*/
+int str_to_cell(String *str, long long *value, Process *process);
 
 
 /**
@@ -169,6 +194,27 @@ void print_process(Process *process, FILE *stream);
 int set_push_args(FILE *listing, Process *process, cmd_t **ip, String *cmd);
 
 
+/**
+ * \brief Prints push or pop arguments to listing
+ * \param [out] listing File for listing
+ * \param [in]  process Process with current command
+ * \param [in]  cmd Current command string
+ * \param [in]  value Constant argument bits
+ * \param [in]  reg Register index
+*/
+void print_push_args(FILE *listing, Process *process, String *cmd, long long value, arg_t reg);
+
+
+/**
+ * \brief Prints constant argument for listing
+ * \param [out] buffer Output string
+ * \param [in]  size Buffer size
+ * \param [in]  process Process with cell type
+ * \param [in]  value Constant argument bits
+*/
+void format_cell(char *buffer, size_t size, Process *process, long long value);
+
+
 /**
  * \brief Sets jmp arguments
  * \param [out] listing File for listing
@@ -181,6 +227,41 @@ int set_push_args(FILE *listing, Process *process, cmd_t **ip, String *cmd);
 int set_jmp_args(FILE *listing, Process *process, cmd_t **ip, String *cmd);
 
 
+/**
+ * \brief Sets register form arguments (destination register, source and label)
+ * \param [out] listing File for listing
+ * \param [in]  process For label search
+ * \param [out] ip This instruction pointer will be moved
+ * \param [in]  cmd Current command string
+ * \param [in]  operands Combination of OPERANDS
+ * \note Sets BIT_REG for register form and BIT_CONST if source is constant
+ * \return Non zero value means error
+*/
+int set_reg_args(FILE *listing, Process *process, cmd_t **ip, String *cmd, int operands);
+
+
+/**
+ * \brief Sets PURE arguments: input stack slots, results and registers routine reads ("pure 1, 1, RAX")
+ * \param [out] listing File for listing
+ * \param [in]  process Current process
+ * \param [out] ip This instruction pointer will be moved
+ * \param [in]  cmd Current command string
+ * \return Non zero value means error
+*/
+int set_pure_args(FILE *listing, Process *process, cmd_t **ip, String *cmd);
+
+
+/**
+ * \brief Sets NCALL argument: hash of native function name resolved by processor at load time
+ * \param [out] listing File for listing
+ * \param [in]  process Current process
+ * \param [out] ip This instruction pointer will be moved
+ * \param [in]  cmd Current command string
+ * \return Non zero value means error
+*/
+int set_native_args(FILE *listing, Process *process, cmd_t **ip, String *cmd);
+
+
 /**
  * \brief Inserts new label
  * \param [in] process For label search
@@ -214,6 +295,9 @@ int main(int argc, char *argv[]) {
     generate_hash_file();
 #else
     int input = -1, output = -1;
+    size_t ram_size = RAM_SIZE;
+    int precision = PRECISION;
+    int cell = CELL_FIXED32;
 
     #include "console/asm_cmd_list.hpp"
 
@@ -234,6 +318,12 @@ int main(int argc, char *argv[]) {
     if (alloc_process(&process, &text))
         return 1;
 
+    process.ram_size = ram_size;
+    process.cell = cell;
+
+    if (fixed_constructor(&process.fixed, precision))
+        return 1;
+
     FILE *listing = fopen("listing.txt", "w");
 
     fprintf(listing, "First pass\n");
@@ -267,9 +357,21 @@ int main(int argc, char *argv[]) {
 #define OFFSET(ip) ip - process -> code
 
 
+#define SET_CMD(ip, code)                       \
+do {                                            \
+    if ((code) < CMD_EXT)                       \
+        *(ip)++ = (cmd_t)(code);                \
+    else {                                      \
+        *(ip)++ = (cmd_t) CMD_EXT;              \
+        *(ip)++ = (cmd_t)((code) - CMD_EXT);    \
+    }                                           \
+} while (0)
+
+
 #define DEF_CMD(name, arg, action, ...) \
     case (CMD_##name##_HASH): { \
-        *process -> ip++ = CMD_##name; \
+        process -> cmd = process -> ip; \
+        SET_CMD(process -> ip, CMD_##name); \
         if (arg) { \
             if (action) { \
                 printf("Wrong argument in line %i!\n", i + 1); \
@@ -277,7 +379,7 @@ int main(int argc, char *argv[]) {
             } \
         } \
         else { \
-            fprintf(listing, "%04zu %04X %-9s %-9s %s\n", OFFSET(process -> ip - 1), CMD_##name, "", "", cmd.str); \
+            fprintf(listing, "%04zu %04X %-9s %-9s %s\n", OFFSET(process -> cmd), CMD_##name, "", "", cmd.str); \
         } \
         break; \
     }
@@ -314,6 +416,7 @@ int translate(Process *process, Text *text, FILE *listing) {
 
 
 #undef DEF_CMD
+#undef SET_CMD
 
 
 int write_file(int file, Process *process) {
@@ -326,9 +429,15 @@ int write_file(int file, Process *process) {
     
     bytes += write(file, &(process -> count), sizeof(size_t));
 
+    bytes += write(file, &(process -> ram_size), sizeof(size_t));
+
+    bytes += write(file, &(process -> fixed.precision), sizeof(int));
+
+    bytes += write(file, &(process -> cell), sizeof(int));
+
     bytes += write(file, process -> code, (unsigned int)(process -> count * sizeof(cmd_t)));
 
-    size_t expected_bytes = strlen(SIGN) + 1 + sizeof(int) + sizeof(size_t) + process -> count * sizeof(cmd_t);
+    size_t expected_bytes = strlen(SIGN) + 1 + 3 * sizeof(int) + 2 * sizeof(size_t) + process -> count * sizeof(cmd_t);
 
     if (bytes != expected_bytes) {
         printf("Expected bytes %zu, actualy written %zu", expected_bytes, bytes);
@@ -339,7 +448,7 @@ int write_file(int file, Process *process) {
 }
 
 
-int get_label_value(Process *process, String *label) {
+long long get_label_value(Process *process, String *label) {
     hash_t label_hash = gnu_hash(label -> str, label -> len);
 
     for(int i = 0; i < process -> labels_count; i++) {
@@ -351,10 +460,34 @@ int get_label_value(Process *process, String *label) {
 }
 
 
-int str_to_int(String *str, arg_t *value) {
-    char *end = nullptr;
-    *value = (arg_t)(strtod(str -> str, &end) * PRECISION);
-    return (end == str -> str + str -> len);
+int str_to_int(String *str, arg_t *value, const Fixed *fixed) {
+    long long number = 0;
+
+    if (fixed_parse(str -> str, str -> str + str -> len, &number, fixed)) return 0;
+
+    *value = (arg_t) number;
+
+    return 1;
+}
+
+
+int str_to_cell(String *str, long long *value, Process *process) {
+    if (process -> cell == CELL_DOUBLE) {
+        double number = 0;
+
+        if (double_parse(str -> str, str -> str + str -> len, &number)) return 0;
+
+        memcpy(value, &number, sizeof(double));
+
+        return 1;
+    }
+
+    if (fixed_parse(str -> str, str -> str + str -> len, value, &process -> fixed)) return 0;
+
+    if (process -> cell == CELL_FIXED32)
+        *value = (arg_t) *value;
+
+    return 1;
 }
 
 
@@ -381,7 +514,7 @@ String get_token(char *origin, const char *solo, const char *extra) {
 
 int get_register_index(String *name) {
     for(size_t i = 0; i < sizeof(REGISTERS) / sizeof(*REGISTERS); i++) {
-        if (!strnicmp(name -> str, REGISTERS[i], name -> len)) return (int) i + 1;
+        if (!strnicmp(name -> str, REGISTERS[i], name -> len)) return (int) i;
     }
 
     return -1;
@@ -434,7 +567,7 @@ int free_process(Process *process) {
 
 void print_process(Process *process, FILE *stream) {
     for(int i = 0; i < process -> labels_count; i++)
-        fprintf(stream, "%.*s %i\n", process -> labels[i].name.len, process -> labels[i].name.str, process -> labels[i].value);
+        fprintf(stream, "%.*s %lli\n", process -> labels[i].name.len, process -> labels[i].name.str, process -> labels[i].value);
 }
 
 
@@ -446,10 +579,23 @@ do {                                \
 } while (0)
 
 
+#define SET_CELL(ip, value)                         \
+do {                                                \
+    long long cell_ = value;                        \
+    if (process -> cell == CELL_FIXED32)            \
+        SET_ARG(ip, (arg_t) cell_);                 \
+    else {                                          \
+        memcpy(ip, &cell_, sizeof(long long));      \
+        (ip) += sizeof(long long);                  \
+    }                                               \
+} while (0)
+
+
 int set_push_args(FILE *listing, Process *process, cmd_t **ip, String *cmd) {
     String arg = get_token(cmd -> str + cmd -> len, "[+]:", "#");
-    cmd_t *flag = *ip - 1;
-    arg_t value = 0;
+    cmd_t *flag = process -> cmd;
+    long long value = 0;
+    arg_t reg = 0;
 
     ASSERT(arg.str, "No argument after push!");
 
@@ -461,15 +607,15 @@ int set_push_args(FILE *listing, Process *process, cmd_t **ip, String *cmd) {
         ASSERT(arg.str, "No closing bracket after integer!");
     }
 
-    if (str_to_int(&arg, &value) || (value = get_label_value(process, &arg)) != -1) {
+    if (str_to_cell(&arg, &value, process) || (value = get_label_value(process, &arg)) != -1) {
         *flag |= BIT_CONST;
         
-        SET_ARG(*ip, value);
+        SET_CELL(*ip, value);
 
         arg = get_token(arg.str + arg.len, "[+]:", "#");
 
         if (!arg.str) {
-            fprintf(listing, "%04zu %04X %-9i %9s %s\n", OFFSET(flag), *flag, *((arg_t *)*ip - 1), "", cmd -> str);
+            print_push_args(listing, process, cmd, value, reg);
 
             return (*flag & BIT_MEM);
         }
@@ -481,33 +627,26 @@ int set_push_args(FILE *listing, Process *process, cmd_t **ip, String *cmd) {
         if (!arg.str || !strnicmp(arg.str, "]", arg.len)) return 1;
     }
 
-    if ((value = get_register_index(&arg)) != -1) {
+    if ((reg = get_register_index(&arg)) != -1) {
         *flag |= BIT_REG;
 
-        SET_ARG(*ip, value);
+        SET_ARG(*ip, reg);
 
         arg = get_token(arg.str + arg.len, "[+]:", "#");
 
         if (!arg.str) {
-            if (*flag & BIT_CONST)
-                fprintf(listing, "%04zu %04X %-9i %-9i %s\n", OFFSET(flag), *flag, *((arg_t *)*ip - 2), *((arg_t *)*ip - 1), cmd -> str);
-            else
-                fprintf(listing, "%04zu %04X %-9i %9s %s\n", OFFSET(flag), *flag, *((arg_t *)*ip - 1), "", cmd -> str);
+            print_push_args(listing, process, cmd, value, reg);
 
             return (*flag & BIT_MEM);
         }
     }
 
     if (!strnicmp(arg.str, "]", arg.len) && (*flag & BIT_MEM)) {
-        if ((*flag & BIT_CONST) && (*flag & BIT_REG)) 
-            fprintf(listing, "%04zu %04X %-9i %-9i %s\n", OFFSET(flag), *flag, *((arg_t *)*ip - 2), *((arg_t *)*ip - 1), cmd -> str);
-        
-        else if ((*flag & BIT_CONST) || (*flag & BIT_REG))
-            fprintf(listing, "%04zu %04X %-9i %9s %s\n", OFFSET(flag), *flag, *((arg_t *)*ip - 1), "", cmd -> str);
-        
-        else
+        if (!(*flag & BIT_CONST) && !(*flag & BIT_REG))
             return 1;
 
+        print_push_args(listing, process, cmd, value, reg);
+
         return 0;
     }
 
@@ -515,6 +654,34 @@ int set_push_args(FILE *listing, Process *process, cmd_t **ip, String *cmd) {
 }
 
 
+void format_cell(char *buffer, size_t size, Process *process, long long value) {
+    if (process -> cell == CELL_DOUBLE) {
+        double number = 0;
+
+        memcpy(&number, &value, sizeof(double));
+
+        snprintf(buffer, size, "%g", number);
+    }
+    else
+        snprintf(buffer, size, "%lli", value);
+}
+
+
+void print_push_args(FILE *listing, Process *process, String *cmd, long long value, arg_t reg) {
+    cmd_t flag = *process -> cmd;
+    char args[2][32] = {"", ""};
+    int count = 0;
+
+    if (flag & BIT_CONST)
+        format_cell(args[count++], sizeof(*args), process, value);
+
+    if (flag & BIT_REG)
+        snprintf(args[count++], sizeof(*args), "%i", reg);
+
+    fprintf(listing, "%04zu %04X %-9s %-9s %s\n", OFFSET(process -> cmd), flag, args[0], args[1], cmd -> str);
+}
+
+
 int set_jmp_args(FILE *listing, Process *process, cmd_t **ip, String *cmd) {
     String arg = get_token(cmd -> str + cmd -> len, "[+]:", "#");
 
@@ -522,17 +689,161 @@ int set_jmp_args(FILE *listing, Process *process, cmd_t **ip, String *cmd) {
 
     arg_t value = 0;
 
-    if (str_to_int(&arg, &value))
+    if (str_to_int(&arg, &value, &process -> fixed))
         SET_ARG(*ip, value);
     else
-        SET_ARG(*ip, get_label_value(process, &arg));
+        SET_ARG(*ip, (arg_t) get_label_value(process, &arg));
+
+    fprintf(listing, "%04zu %04X %-9i %9s %s\n", OFFSET(process -> cmd), *process -> cmd, *((arg_t *)*ip - 1), "", cmd -> str);
+
+    return 0;
+}
+
+
+int set_pure_args(FILE *listing, Process *process, cmd_t **ip, String *cmd) {
+    size_t counts[2] = {};
+    String arg = {cmd -> str, cmd -> len};
+
+    for(int i = 0; i < 2; i++) {
+        if (i) {
+            arg = get_token(arg.str + arg.len, "[+]:,", "#");
+
+            if (!arg.str || *arg.str != ',') return 1;
+        }
+
+        arg = get_token(arg.str + arg.len, "[+]:,", "#");
+
+        if (!arg.str) return 1;
+
+        char *end = nullptr;
+        counts[i] = strtoul(arg.str, &end, 10);
+
+        if (end != arg.str + arg.len) return 1;
+    }
+
+    cmd_t mask = 0;
+    size_t inputs = counts[0];
+
+    while ((arg = get_token(arg.str + arg.len, "[+]:,", "#")).str) {
+        if (*arg.str != ',') return 1;
+
+        arg = get_token(arg.str + arg.len, "[+]:,", "#");
+
+        arg_t reg = (arg.str) ? get_register_index(&arg) : -1;
+
+        if (reg == -1) return 1;
+
+        inputs += !(mask & (1 << reg));
+        mask = (cmd_t)(mask | (1 << reg));
+    }
+
+    if (inputs > PURE_VALUES || counts[1] > PURE_VALUES) {
+        printf("Pure routine can't have more than %zu inputs and %zu results!\n", PURE_VALUES, PURE_VALUES);
+        return 1;
+    }
+
+    *(*ip)++ = (cmd_t) counts[0];
+    *(*ip)++ = (cmd_t) counts[1];
+    *(*ip)++ = mask;
+
+    fprintf(listing, "%04zu %04X %-9zu %-9zu %s\n", OFFSET(process -> cmd), *process -> cmd, counts[0], counts[1], cmd -> str);
+
+    return 0;
+}
+
+
+int set_native_args(FILE *listing, Process *process, cmd_t **ip, String *cmd) {
+    String arg = get_token(cmd -> str + cmd -> len, "[+]:,", "#");
+
+    if (!arg.str) return 1;
+
+    SET_ARG(*ip, native_hash(arg.str, (size_t) arg.len));
 
-    fprintf(listing, "%04zu %04X %-9i %9s %s\n", OFFSET(*ip - sizeof(cmd_t) - sizeof(arg_t)), *(*ip - sizeof(cmd_t) - sizeof(arg_t)), *((arg_t *)*ip - 1), "", cmd -> str);
+    fprintf(listing, "%04zu %04X %-9X %9s %s\n", OFFSET(process -> cmd), *process -> cmd, (unsigned int) *((arg_t *)*ip - 1), "", cmd -> str);
 
     return 0;
 }
 
 
+int set_reg_args(FILE *listing, Process *process, cmd_t **ip, String *cmd, int operands) {
+    String arg = get_token(cmd -> str + cmd -> len, "[+]:,", "#");
+    cmd_t *flag = process -> cmd;
+    arg_t dst = (arg.str) ? get_register_index(&arg) : -1;
+
+    if (dst == -1) {
+        if (!(operands & OPERAND_STACK)) return 1;
+
+        if (operands & OPERAND_LABEL) return set_jmp_args(listing, process, ip, cmd);
+
+        if (arg.str) return 1;
+
+        fprintf(listing, "%04zu %04X %-9s %-9s %s\n", OFFSET(flag), *flag, "", "", cmd -> str);
+
+        return 0;
+    }
+
+    *flag |= BIT_REG;
+
+    SET_ARG(*ip, dst);
+
+    char src[32] = "";
+
+    if (operands & OPERAND_SRC) {
+        arg = get_token(arg.str + arg.len, "[+]:,", "#");
+
+        if (!arg.str || *arg.str != ',') return 1;
+
+        arg = get_token(arg.str + arg.len, "[+]:,", "#");
+
+        if (!arg.str) return 1;
+
+        arg_t src_reg = get_register_index(&arg);
+        long long value = 0;
+
+        if (src_reg != -1) {
+            SET_ARG(*ip, src_reg);
+
+            snprintf(src, sizeof(src), "%i", src_reg);
+        }
+        else if (str_to_cell(&arg, &value, process) || (value = get_label_value(process, &arg)) != -1) {
+            *flag |= BIT_CONST;
+
+            SET_CELL(*ip, value);
+
+            format_cell(src, sizeof(src), process, value);
+        }
+        else
+            return 1;
+    }
+
+    if (operands & OPERAND_LABEL) {
+        arg = get_token(arg.str + arg.len, "[+]:,", "#");
+
+        if (!arg.str || *arg.str != ',') return 1;
+
+        arg = get_token(arg.str + arg.len, "[+]:,", "#");
+
+        if (!arg.str) return 1;
+
+        arg_t target = 0;
+
+        if (!str_to_int(&arg, &target, &process -> fixed))
+            target = (arg_t) get_label_value(process, &arg);
+
+        SET_ARG(*ip, target);
+    }
+
+    if (get_token(arg.str + arg.len, "[+]:,", "#").str) return 1;
+
+    fprintf(listing, "%04zu %04X %-9i %-9s %s\n", OFFSET(flag), *flag, dst, src, cmd -> str);
+
+    return 0;
+}
+
+
+#undef SET_CELL
+
+
 int set_label_value(Process *process, String *cmd) {
     String arg = get_token(cmd -> str + cmd -> len, "[+]:", "#");
 
@@ -549,9 +860,9 @@ int set_label_value(Process *process, String *cmd) {
             arg = get_token(arg.str + arg.len, "[+]:", "#");
 
             if (arg.str) {
-                arg_t value = 0;
+                long long value = 0;
 
-                if (str_to_int(&arg, &value)) {
+                if (str_to_cell(&arg, &value, process)) {
                     if (get_label_value(process, cmd) == -1)
                         process -> labels[process -> labels_count++] = {value, *cmd, gnu_hash(cmd -> str, cmd -> len)};
                             
@@ -0,0 +1,202 @@
+/**
+ * \file
+ * \brief Basic blocks: code is split at jump targets and after jumps, every block is dispatched at once
+ * \note Include it after execute() and decode.hpp while DEF_CMD is defined, commands are executed with handlers from cmd.hpp
+*/
+
+
+/// Decoded command of basic block
+typedef struct {
+    unsigned int offset = 0;    ///< Command offset
+    unsigned int args = 0;      ///< Offset of command arguments
+    unsigned short code = 0;    ///< Command code
+    cmd_t cmd = 0;              ///< First command byte with argument bits
+} BlockCommand;
+
+
+/// Basic block
+typedef struct Block {
+    const BlockCommand *commands = nullptr; ///< Block commands
+    size_t count = 0;                       ///< Command count
+    const cmd_t *start = nullptr;           ///< First command
+    const cmd_t *end = nullptr;             ///< Command after the last one
+    const struct Block *taken = nullptr;    ///< Jump target of the last command (nullptr if it is not a jump)
+    const struct Block *next = nullptr;     ///< Block right after this one (nullptr at the end of code)
+} Block;
+
+
+/// Program split into basic blocks
+typedef struct {
+    Block *blocks = nullptr;                ///< Blocks in code order
+    size_t count = 0;                       ///< Block count
+    BlockCommand *commands = nullptr;       ///< Commands of all blocks
+    const Block **index = nullptr;          ///< Block by its start offset (nullptr for other offsets)
+} BlockCode;
+
+
+/**
+ * \brief Splits process code into basic blocks
+ * \param [in]  process Process with code
+ * \param [out] blockcode Blocks
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int blocks_build(Process<Policy> *process, BlockCode *blockcode) {
+    typedef typename Policy::cell_t cell_t;
+
+    ASSERT(process && blockcode, "Can't work with then null pointer!");
+
+    size_t count = process -> count;
+    const cmd_t *code = process -> code;
+
+    cmd_t *marks = (cmd_t *) calloc(count + 1, sizeof(cmd_t));
+
+    ASSERT(marks, "Can't allocate block marks!");
+
+    size_t commands = blocks_mark<cell_t>(code, count, marks);
+
+    for(size_t offset = 0; offset < count; offset++)
+        blockcode -> count += (marks[offset] & MARK_BLOCK) && (marks[offset] & MARK_COMMAND);
+
+    blockcode -> blocks = (Block *) calloc(blockcode -> count + 1, sizeof(Block));
+    blockcode -> commands = (BlockCommand *) calloc(commands + 1, sizeof(BlockCommand));
+    blockcode -> index = (const Block **) calloc(count + 1, sizeof(Block *));
+
+    if (!blockcode -> blocks || !blockcode -> commands || !blockcode -> index) {
+        free(marks);
+        ASSERT(0, "Can't allocate blocks!");
+    }
+
+    Block *block = blockcode -> blocks - 1;
+    BlockCommand *command = blockcode -> commands;
+
+    for(size_t offset = 0; offset < count; command++) {
+        if (marks[offset] & MARK_BLOCK) {
+            if (block >= blockcode -> blocks)
+                block -> next = block + 1;
+
+            block++;
+            block -> commands = command;
+            block -> start = code + offset;
+
+            blockcode -> index[offset] = block;
+        }
+
+        command -> offset = (unsigned int) offset;
+        command -> cmd = code[offset++];
+        command -> code = (unsigned short)(command -> cmd & CMD_MASK);
+
+        if (command -> code == CMD_EXT)
+            command -> code = (unsigned short)(command -> code + code[offset++]);
+
+        command -> args = (unsigned int) offset;
+
+        offset += command_args_size<cell_t>(command -> code, (cmd_t)(command -> cmd & ~CMD_MASK));
+
+        block -> count++;
+        block -> end = code + offset;
+    }
+
+    for(size_t i = 0; i < blockcode -> count; i++) {
+        Block *current = blockcode -> blocks + i;
+        const BlockCommand *last = current -> commands + current -> count - 1;
+
+        if (!command_is_jump(last -> code)) continue;
+
+        arg_t target = *((const arg_t *)(current -> end - sizeof(arg_t)));
+
+        if (target > -1 && (size_t) target < count)
+            current -> taken = blockcode -> index[target];
+    }
+
+    free(marks);
+
+    return 0;
+}
+
+
+/**
+ * \brief Executes process block by block
+ * \param process Process to execute
+ * \param [in] blockcode Blocks of process code
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int blocks_execute(Process<Policy> *process, const BlockCode *blockcode) {
+    typedef typename Policy::cell_t cell_t;
+
+    /// SHORTCUTS ///
+    const cmd_t *ip = process -> ip;
+
+    Stack<cell_t> *stack = &(process -> value_stack);
+    Stack<int> *call_stack = &(process -> call_stack);
+
+    cell_t *reg = process -> reg;
+    cell_t *ram = process -> ram;
+
+    Trace *trace = process -> trace;
+
+    const Fixed *fixed = &(process -> fixed);
+
+    // Restored process starts from the block after SNAPSHOT
+    size_t start = (size_t)(OFFSET(ip));
+    const Block *block = (start < process -> count) ? blockcode -> index[start] : nullptr;
+
+    ASSERT_IP(block || start >= process -> count, "Jump to the middle of command!", start);
+
+    while (block) {
+        const BlockCommand *command = block -> commands, *last = command + block -> count;
+
+        for(; command < last; command++) {
+            cmd_t cmd = command -> cmd;
+            unsigned int code = command -> code;
+
+            ip = process -> code + command -> args;
+
+            if (trace)
+                trace_record(trace, command -> offset, code, (cmd_t)(cmd & ~CMD_MASK), (stack -> size) ? Policy::to_units(stack -> data[stack -> size - 1], fixed) : 0);
+
+            switch(code) {
+                #include "cmd.hpp"
+
+                default: {
+                    printf("Unknown command %u in operation %zu!\n", code, OFFSET(ip - 1));
+                    return 1;
+                }
+            }
+        }
+
+        // Successors are cached, only returns need index lookup
+        if (ip == block -> end)
+            block = block -> next;
+
+        else if (block -> taken && ip == block -> taken -> start)
+            block = block -> taken;
+
+        else {
+            size_t offset = (size_t)(OFFSET(ip));
+
+            if (offset >= process -> count) break;
+
+            block = blockcode -> index[offset];
+
+            ASSERT_IP(block, "Jump to the middle of command!", offset);
+        }
+    }
+
+    printf("[Warning] No hlt at end of the process!\n");
+    return 0;
+}
+
+
+/**
+ * \brief Frees blocks
+ * \param [in] blockcode Blocks to free
+*/
+inline void blocks_free(BlockCode *blockcode) {
+    free(blockcode -> blocks);
+    free(blockcode -> commands);
+    free(blockcode -> index);
+
+    *blockcode = {};
+}
@@ -3,17 +3,20 @@ DEF_CMD(HLT, 0, 0,
 )
 
 DEF_CMD(PUSH, 1, set_push_args(listing, process, &process -> ip, &cmd), 
+    cell_t arg = 0;
+
     if (cmd & BIT_CONST) {
-        arg = *((arg_t *)(ip));
-        ip += sizeof(arg_t);
+        arg = *((const cell_t *)(ip));
+        ip += sizeof(cell_t);
     }
     if (cmd & BIT_REG) {
-        arg += reg[*((arg_t *)(ip)) - 1]; // FORGOT TO DECREMENT ARGUMENT
+        arg += reg[*((const arg_t *)(ip))];
         ip += sizeof(arg_t);
     }
     if (cmd & BIT_MEM) {
-        ASSERT_IP(arg > -1 && arg / 1000 < (int) RAM_SIZE, "Segmentation fault! Wrong RAM index!", OFFSET(ip - 1));
-        arg = ram[arg / PRECISION];
+        long long index = Policy::to_int(arg, fixed);
+        RAM_INDEX_(index, OFFSET(ip - 1));
+        arg = ram[index];
     }
 
     PUSH_(arg);
@@ -23,31 +26,62 @@ DEF_CMD(OUT, 0, 0,
     OUT_();
 )
 
-DEF_CMD(ADD, 0, 0,
-    POP_(val1);
-    POP_(val2);
-    PUSH_(val2 + val1);
+DEF_CMD(ADD, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_STACK),
+    if (cmd & BIT_REG) {
+        REG_OPERAND_(index);
+        SRC_OPERAND_(val1);
+        reg[index] = reg[index] + val1;
+    }
+    else {
+        POP_(val1);
+        POP_(val2);
+        PUSH_(val2 + val1);
+    }
 )
 
-DEF_CMD(SUB, 0, 0,
-    POP_(val1);
-    POP_(val2);
-    PUSH_(val2 - val1);
+DEF_CMD(SUB, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_STACK),
+    if (cmd & BIT_REG) {
+        REG_OPERAND_(index);
+        SRC_OPERAND_(val1);
+        reg[index] = reg[index] - val1;
+    }
+    else {
+        POP_(val1);
+        POP_(val2);
+        PUSH_(val2 - val1);
+    }
 )
 
-DEF_CMD(MUL, 0, 0,
-    POP_(val1);
-    POP_(val2);
-    PUSH_((int)((long long)val2 * (long long)val1 / (long long)PRECISION));
+DEF_CMD(MUL, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_STACK),
+    if (cmd & BIT_REG) {
+        REG_OPERAND_(index);
+        SRC_OPERAND_(val1);
+        reg[index] = Policy::mul(reg[index], val1, fixed);
+    }
+    else {
+        POP_(val1);
+        POP_(val2);
+        PUSH_(Policy::mul(val2, val1, fixed));
+    }
 )
 
-DEF_CMD(DIV, 0, 0,
-    POP_(val1);
-    POP_(val2);
+DEF_CMD(DIV, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_STACK),
+    if (cmd & BIT_REG) {
+        REG_OPERAND_(index);
+        SRC_OPERAND_(val1);
+
+        ASSERT_IP(!Policy::equal(val1, 0), "Zero division!", OFFSET(ip - 1));
+
+        reg[index] = Policy::div(reg[index], val1, fixed);
+    }
+    else {
+        POP_(val1);
+        POP_(val2);
 
-    ASSERT_IP(val1, "Zero division!", OFFSET(ip - 1));
+        ASSERT_IP(!Policy::equal(val1, 0), "Zero division!", OFFSET(ip - 1));
 
-    PUSH_((int)((float)val2 / (float)val1 * PRECISION));
+        PUSH_(Policy::div(val2, val1, fixed));
+    }
 )
 
 DEF_CMD(JMP, 1, set_jmp_args(listing, process, &process -> ip, &cmd),
@@ -61,57 +95,116 @@ DEF_CMD(DUP, 0, 0,
 )
 
 DEF_CMD(POP, 1, set_push_args(listing, process, &process -> ip, &cmd), 
-    if (execute_pop(process, &ip, cmd, arg))
+    if (execute_pop(process, &ip, cmd))
         return 1;
 )
 
-DEF_CMD(JB, 1, set_jmp_args(listing, process, &process -> ip, &cmd),
-    POP_(val1);
-    POP_(val2);
+DEF_CMD(JB, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_LABEL | OPERAND_STACK),
+    if (cmd & BIT_REG) {
+        REG_OPERAND_(index);
+        SRC_OPERAND_(val1);
+
+        JMP_IF_(reg[index] < val1);
+    }
+    else {
+        POP_(val1);
+        POP_(val2);
 
-    JMP_IF_(val2 < val1);
+        JMP_IF_(val2 < val1);
+    }
 )
 
-DEF_CMD(JA, 1, set_jmp_args(listing, process, &process -> ip, &cmd),
-    POP_(val1);
-    POP_(val2);
+DEF_CMD(JA, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_LABEL | OPERAND_STACK),
+    if (cmd & BIT_REG) {
+        REG_OPERAND_(index);
+        SRC_OPERAND_(val1);
+
+        JMP_IF_(reg[index] > val1);
+    }
+    else {
+        POP_(val1);
+        POP_(val2);
 
-    JMP_IF_(val2 > val1);
+        JMP_IF_(val2 > val1);
+    }
 )
 
-DEF_CMD(JE, 1, set_jmp_args(listing, process, &process -> ip, &cmd),
-    POP_(val1);
-    POP_(val2);
+DEF_CMD(JE, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_LABEL | OPERAND_STACK),
+    if (cmd & BIT_REG) {
+        REG_OPERAND_(index);
+        SRC_OPERAND_(val1);
+
+        JMP_IF_(Policy::equal(reg[index], val1));
+    }
+    else {
+        POP_(val1);
+        POP_(val2);
 
-    JMP_IF_(val2 == val1);
+        JMP_IF_(Policy::equal(val2, val1));
+    }
 )
 
-DEF_CMD(JNE, 1, set_jmp_args(listing, process, &process -> ip, &cmd),
-    POP_(val1);
-    POP_(val2);
+DEF_CMD(JNE, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_LABEL | OPERAND_STACK),
+    if (cmd & BIT_REG) {
+        REG_OPERAND_(index);
+        SRC_OPERAND_(val1);
+
+        JMP_IF_(!Policy::equal(reg[index], val1));
+    }
+    else {
+        POP_(val1);
+        POP_(val2);
 
-    JMP_IF_(val2 != val1);
+        JMP_IF_(!Policy::equal(val2, val1));
+    }
 )
 
 
-DEF_CMD(JAE, 1, set_jmp_args(listing, process, &process -> ip, &cmd),
-    POP_(val1);
-    POP_(val2);
+DEF_CMD(JAE, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_LABEL | OPERAND_STACK),
+    if (cmd & BIT_REG) {
+        REG_OPERAND_(index);
+        SRC_OPERAND_(val1);
+
+        JMP_IF_(reg[index] >= val1);
+    }
+    else {
+        POP_(val1);
+        POP_(val2);
 
-    JMP_IF_(val2 >= val1);
+        JMP_IF_(val2 >= val1);
+    }
 )
 
 
-DEF_CMD(JBE, 1, set_jmp_args(listing, process, &process -> ip, &cmd),
-    POP_(val1);
-    POP_(val2);
+DEF_CMD(JBE, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_LABEL | OPERAND_STACK),
+    if (cmd & BIT_REG) {
+        REG_OPERAND_(index);
+        SRC_OPERAND_(val1);
 
-    JMP_IF_(val2 <= val1);
+        JMP_IF_(reg[index] <= val1);
+    }
+    else {
+        POP_(val1);
+        POP_(val2);
+
+        JMP_IF_(val2 <= val1);
+    }
 )
 
 
 DEF_CMD(CALL, 1, set_jmp_args(listing, process, &process -> ip, &cmd),
-    CALL_();
+    const cmd_t *pure = (process -> pure) ? command_pure(process -> code, process -> count, *((const arg_t *)(ip))) : nullptr;
+
+    // Pure routine is executed at once or its results are taken from cache
+    if (pure) {
+        arg_t target = *((const arg_t *)(ip));
+        ip += sizeof(arg_t);
+
+        ASSERT_IP(!pure_call(process, reg, target, pure), "Pure routine failed!", OFFSET(ip - 1));
+    }
+    else {
+        CALL_();
+    }
 )
 
 DEF_CMD(RET, 0, 0,
@@ -123,15 +216,22 @@ DEF_CMD(SQRT, 0, 0,
 
     ASSERT_IP(val >= 0, "Negative number under root!", OFFSET(ip - 1));
 
-    PUSH_((int) (sqrt((float)val / PRECISION) * PRECISION));
+    PUSH_(Policy::sqrt(val, fixed));
 )
 
 DEF_CMD(IN, 0, 0,
-    float value = 0;
+    // Green process waits for input while others work
+    if (process -> quantum && !io_ready(process -> io)) {
+        REPEAT_(CMD_IN);
+    }
+
+    cell_t value = 0;
 
-    ASSERT(scanf("%f", &value), "Wrong argument given!");
+    // Ended input gives 0 as scanf() did
+    if (!io_end(process -> io))
+        ASSERT_IP(io_read(process -> io, &value, 1, fixed) == 1, "Wrong argument given!", OFFSET(ip - 1));
 
-    PUSH_((int)(value * PRECISION));
+    PUSH_(value);
 )
 
 DEF_CMD(SHOW, 0, 0,
@@ -141,6 +241,406 @@ DEF_CMD(SHOW, 0, 0,
 
 
 DEF_CMD(CLR, 0, 0,
-    system("CLS");
-    //printf("\e[H\e[2J\e[3J");
+    ASSERT_IP(!screen_clear(process -> screen, process -> screen -> file), "Can't clear screen!", OFFSET(ip - 1));
+)
+
+
+DEF_CMD(FILL, 0, 0,
+    POP_COUNT_(count);
+    POP_(value);
+    POP_(dst);
+
+    RANGE_(dst_ptr, dst, count);
+
+    Policy::vfill(dst_ptr, value, (size_t) count);
+)
+
+
+DEF_CMD(COPY, 0, 0,
+    POP_COUNT_(count);
+    POP_(src);
+    POP_(dst);
+
+    RANGE_(src_ptr, src, count);
+    RANGE_(dst_ptr, dst, count);
+
+    memmove(dst_ptr, src_ptr, (size_t) count * sizeof(cell_t));
+)
+
+
+DEF_CMD(VADD, 0, 0,
+    POP_COUNT_(count);
+    POP_(b);
+    POP_(a);
+    POP_(dst);
+
+    RANGE_(b_ptr, b, count);
+    RANGE_(a_ptr, a, count);
+    RANGE_(dst_ptr, dst, count);
+
+    Policy::vadd(dst_ptr, a_ptr, b_ptr, (size_t) count);
+)
+
+
+DEF_CMD(VSUB, 0, 0,
+    POP_COUNT_(count);
+    POP_(b);
+    POP_(a);
+    POP_(dst);
+
+    RANGE_(b_ptr, b, count);
+    RANGE_(a_ptr, a, count);
+    RANGE_(dst_ptr, dst, count);
+
+    Policy::vsub(dst_ptr, a_ptr, b_ptr, (size_t) count);
+)
+
+
+DEF_CMD(VMUL, 0, 0,
+    POP_COUNT_(count);
+    POP_(b);
+    POP_(a);
+    POP_(dst);
+
+    RANGE_(b_ptr, b, count);
+    RANGE_(a_ptr, a, count);
+    RANGE_(dst_ptr, dst, count);
+
+    Policy::vmul(dst_ptr, a_ptr, b_ptr, (size_t) count, fixed);
+)
+
+
+DEF_CMD(VDOT, 0, 0,
+    POP_COUNT_(count);
+    POP_(b);
+    POP_(a);
+
+    RANGE_(b_ptr, b, count);
+    RANGE_(a_ptr, a, count);
+
+    PUSH_(Policy::vdot(a_ptr, b_ptr, (size_t) count, fixed));
+)
+
+
+DEF_CMD(VSUM, 0, 0,
+    POP_COUNT_(count);
+    POP_(src);
+
+    RANGE_(src_ptr, src, count);
+
+    PUSH_(Policy::vsum(src_ptr, (size_t) count));
+)
+
+
+DEF_CMD(VMIN, 0, 0,
+    POP_COUNT_(count);
+    POP_(src);
+
+    RANGE_(src_ptr, src, count);
+
+    ASSERT_IP(count > 0, "Empty range!", OFFSET(ip - 1));
+
+    PUSH_(Policy::vmin(src_ptr, (size_t) count));
+)
+
+
+DEF_CMD(VMAX, 0, 0,
+    POP_COUNT_(count);
+    POP_(src);
+
+    RANGE_(src_ptr, src, count);
+
+    ASSERT_IP(count > 0, "Empty range!", OFFSET(ip - 1));
+
+    PUSH_(Policy::vmax(src_ptr, (size_t) count));
+)
+
+
+DEF_CMD(READ, 0, 0,
+    POP_COUNT_(count);
+    POP_(dst);
+    POP_CHANNEL_(channel);
+
+    RANGE_(dst_ptr, dst, count);
+
+    ASSERT_IP(channel -> in_file != -1, "Channel input is not bound!", OFFSET(ip - 1));
+
+    PUSH_(Policy::from_int((long long) io_read(channel, dst_ptr, (size_t) count, fixed), fixed));
+)
+
+
+DEF_CMD(WRITE, 0, 0,
+    POP_COUNT_(count);
+    POP_(src);
+    POP_CHANNEL_(channel);
+
+    RANGE_(src_ptr, src, count);
+
+    ASSERT_IP(channel -> out, "Channel output is not bound!", OFFSET(ip - 1));
+
+    ASSERT_IP(io_write(channel, src_ptr, (size_t) count, fixed) == (size_t) count, "Can't write values!", OFFSET(ip - 1));
+)
+
+
+DEF_CMD(INC, 1, set_reg_args(listing, process, &process -> ip, &cmd, 0),
+    REG_OPERAND_(index);
+
+    reg[index] = reg[index] + Policy::from_int(1, fixed);
+)
+
+
+DEF_CMD(DEC, 1, set_reg_args(listing, process, &process -> ip, &cmd, 0),
+    REG_OPERAND_(index);
+
+    reg[index] = reg[index] - Policy::from_int(1, fixed);
+)
+
+
+DEF_CMD(MOV, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC),
+    REG_OPERAND_(index);
+    SRC_OPERAND_(value);
+
+    reg[index] = value;
+)
+
+
+DEF_CMD(SPAWN, 1, set_jmp_args(listing, process, &process -> ip, &cmd),
+    arg_t target = *((const arg_t *)(ip));
+    ip += sizeof(arg_t);
+
+    int thread = spawn_thread(process, reg, target);
+
+    ASSERT_IP(thread > -1, "Can't spawn thread!", OFFSET(ip - 1));
+
+    PUSH_(Policy::from_int(thread, fixed));
+)
+
+
+DEF_CMD(JOIN, 0, 0,
+    POP_(thread);
+
+    ASSERT_IP(!join_thread(process, Policy::to_int(thread, fixed)), "Thread is not running or failed!", OFFSET(ip - 1));
+)
+
+
+DEF_CMD(AADD, 0, 0,
+    POP_(value);
+    POP_(addr);
+
+    RANGE_(ptr, addr, 1);
+
+    PUSH_(Policy::atomic_add(ptr, value));
+)
+
+
+DEF_CMD(AXCHG, 0, 0,
+    POP_(value);
+    POP_(addr);
+
+    RANGE_(ptr, addr, 1);
+
+    PUSH_(Policy::atomic_exchange(ptr, value));
+)
+
+
+DEF_CMD(ACAS, 0, 0,
+    POP_(desired);
+    POP_(expected);
+    POP_(addr);
+
+    RANGE_(ptr, addr, 1);
+
+    PUSH_(Policy::atomic_cas(ptr, expected, desired));
+)
+
+
+DEF_CMD(PARFOR, 1, set_reg_args(listing, process, &process -> ip, &cmd, OPERAND_SRC | OPERAND_LABEL),
+    REG_OPERAND_(index);
+    SRC_OPERAND_(end);
+
+    arg_t target = *((const arg_t *)(ip));
+    ip += sizeof(arg_t);
+
+    ASSERT_IP(!parallel_for(process, reg, index, end, target), "PARFOR body failed!", OFFSET(ip - 1));
+)
+
+
+DEF_CMD(GO, 1, set_jmp_args(listing, process, &process -> ip, &cmd),
+    arg_t target = *((const arg_t *)(ip));
+    ip += sizeof(arg_t);
+
+    ASSERT_IP(!green_start(process, reg, target), "Can't start green process!", OFFSET(ip - 1));
+)
+
+
+DEF_CMD(YIELD, 0, 0,
+    if (process -> quantum) {
+        process -> ip = ip;
+        process -> yielded = 1;
+        return 0;
+    }
+)
+
+
+DEF_CMD(SEND, 0, 0,
+    POP_(value);
+    POP_MESSAGES_(channel);
+
+    size_t attempt = 0;
+
+    while (!msg_send(channel, &value, 1)) {
+        ASSERT_IP(!msg_closed(channel), "Message channel is closed!", OFFSET(ip - 1));
+
+        if (process -> quantum) {
+            PUSH_(channel_cell);
+            PUSH_(value);
+            REPEAT_(CMD_SEND);
+        }
+
+        thread_backoff(attempt++);
+    }
+)
+
+
+DEF_CMD(RECV, 0, 0,
+    POP_MESSAGES_(channel);
+
+    cell_t value = 0;
+
+    size_t attempt = 0;
+
+    while (!msg_recv(channel, &value, 1)) {
+        ASSERT_IP(!msg_closed(channel), "Message channel is closed!", OFFSET(ip - 1));
+
+        if (process -> quantum) {
+            PUSH_(channel_cell);
+            REPEAT_(CMD_RECV);
+        }
+
+        thread_backoff(attempt++);
+    }
+
+    PUSH_(value);
+)
+
+
+DEF_CMD(TRYSEND, 0, 0,
+    POP_(value);
+    POP_MESSAGES_(channel);
+
+    PUSH_(Policy::from_int((long long) msg_send(channel, &value, 1), fixed));
+)
+
+
+DEF_CMD(TRYRECV, 0, 0,
+    POP_MESSAGES_(channel);
+
+    cell_t value = 0;
+    size_t received = msg_recv(channel, &value, 1);
+
+    PUSH_(value);
+    PUSH_(Policy::from_int((long long) received, fixed));
+)
+
+
+DEF_CMD(SENDN, 0, 0,
+    POP_COUNT_(count);
+    POP_(addr);
+    POP_MESSAGES_(channel);
+
+    RANGE_(ptr, addr, count);
+
+    size_t done = 0;
+
+    size_t attempt = 0;
+
+    while ((done += msg_send(channel, ptr + done, (size_t) count - done)) < (size_t) count) {
+        ASSERT_IP(!msg_closed(channel), "Message channel is closed!", OFFSET(ip - 1));
+
+        if (process -> quantum) {
+            PUSH_(channel_cell);
+            PUSH_(addr + Policy::from_int((long long) done, fixed));
+            PUSH_(Policy::from_int(count - (long long) done, fixed));
+            REPEAT_(CMD_SENDN);
+        }
+
+        thread_backoff(attempt++);
+    }
+)
+
+
+DEF_CMD(RECVN, 0, 0,
+    POP_COUNT_(count);
+    POP_(addr);
+    POP_MESSAGES_(channel);
+
+    RANGE_(ptr, addr, count);
+
+    size_t done = 0;
+
+    size_t attempt = 0;
+
+    while ((done += msg_recv(channel, ptr + done, (size_t) count - done)) < (size_t) count) {
+        ASSERT_IP(!msg_closed(channel), "Message channel is closed!", OFFSET(ip - 1));
+
+        if (process -> quantum) {
+            PUSH_(channel_cell);
+            PUSH_(addr + Policy::from_int((long long) done, fixed));
+            PUSH_(Policy::from_int(count - (long long) done, fixed));
+            REPEAT_(CMD_RECVN);
+        }
+
+        thread_backoff(attempt++);
+    }
+)
+
+
+DEF_CMD(SNAPSHOT, 0, 0,
+    if (process -> snapshot != -1)
+        ASSERT_IP(!snapshot_write(process, reg, ip), "Can't write snapshot!", OFFSET(ip - 1));
+)
+
+
+DEF_CMD(FORK, 1, set_reg_args(listing, process, &process -> ip, &cmd, 0),
+    REG_OPERAND_(index);
+
+    long long child = fork_process(process);
+
+    ASSERT_IP(child > -1, "Can't fork process!", OFFSET(ip - 1));
+
+    reg[index] = Policy::from_int(child, fixed);
+)
+
+
+DEF_CMD(PURE, 1, set_pure_args(listing, process, &process -> ip, &cmd),
+    ip += PURE_ARGS;
+)
+
+
+DEF_CMD(NCALL, 1, set_native_args(listing, process, &process -> ip, &cmd),
+    arg_t hash = *((const arg_t *)(ip));
+    ip += sizeof(arg_t);
+
+    ASSERT_IP(!native_call(process, hash), "Native function failed!", OFFSET(ip - 1));
+)
+
+
+DEF_CMD(ALLOC, 0, 0,
+    POP_COUNT_(count);
+
+    ASSERT_IP(process -> heap && process -> heap -> ram == ram, "Heap is not available!", OFFSET(ip - 1));
+
+    long long index = -1;
+
+    ASSERT_IP(!heap_alloc(process -> heap, (size_t) count, &index), "Heap free list is broken!", OFFSET(ip - 1));
+
+    PUSH_(Policy::from_int(index, fixed));
+)
+
+
+DEF_CMD(FREE, 0, 0,
+    POP_(addr);
+
+    ASSERT_IP(process -> heap && process -> heap -> ram == ram, "Heap is not available!", OFFSET(ip - 1));
+    ASSERT_IP(!heap_free(process -> heap, Policy::to_int(addr, fixed)), "Address is not heap block!", OFFSET(ip - 1));
 )
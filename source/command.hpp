@@ -16,7 +16,15 @@ typedef enum {
 } ARG_TYPE;
 
 
-/// Real number precision
+/// Command code bits of the first command byte
+const unsigned int CMD_MASK = 0x1F;
+
+
+/// Command codes starting from this one take two bytes: CMD_EXT with argument bits and then (code - CMD_EXT)
+const unsigned int CMD_EXT = 0x1F;
+
+
+/// Default real number precision
 const int PRECISION = 1000;
 
 
@@ -25,7 +33,30 @@ const char *SIGN = "AT-AT";
 
 
 /// Version
-const int VERSION = 1;
+const int VERSION = 6;
+
+
+/// Type of cells processor works with (selected by the assembler and stored in binary header)
+typedef enum {
+    CELL_FIXED32 = 0, ///< 32 bit fixed point numbers
+    CELL_FIXED64 = 1, ///< 64 bit fixed point numbers
+    CELL_DOUBLE  = 2, ///< IEEE 754 double precision numbers
+} CELL_TYPE;
+
+
+/// Cell size in bytes by CELL_TYPE
+const size_t CELL_SIZE[] = {sizeof(int), sizeof(long long), sizeof(double)};
+
+
+/// Default RAM size in cells
+const size_t RAM_SIZE = 1200;
+
+
+/// Maximum number of input values (stack slots and registers) and results of pure routine
+const size_t PURE_VALUES = 8;
+
+/// Size of PURE arguments: input stack slots, results and mask of registers routine reads
+const size_t PURE_ARGS = 3;
 
 
 /// Command type
@@ -34,3 +65,23 @@ typedef unsigned char cmd_t;
 
 /// Command argument type
 typedef int arg_t;
+
+
+/// Maximum number of arguments and results of native function
+const size_t NATIVE_VALUES = 8;
+
+
+/**
+ * \brief Calculates native function name hash written as NCALL argument (FNV-1a)
+ * \param [in] name Name start
+ * \param [in] length Name length
+ * \return Hash
+*/
+inline arg_t native_hash(const char *name, size_t length) {
+    unsigned int hash = 2166136261u;
+
+    for(size_t i = 0; i < length; i++)
+        hash = (hash ^ (unsigned char) name[i]) * 16777619u;
+
+    return (arg_t) hash;
+}
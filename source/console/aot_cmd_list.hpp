@@ -0,0 +1,23 @@
+Command command_list[] = {
+    {
+        "-i", "--input", 
+        0, 
+        &set_input_file, 
+        &input,
+        "<filepath> Path to binary file written by asm.exe"
+    },
+    {
+        "-o", "--output", 
+        0, 
+        &set_output_file, 
+        &output,
+        "<filepath> Path to C++ output file (build it with make native)"
+    },
+    {
+        "-h", "--help", 
+        0, 
+        &show_help, 
+        &command_list,
+        "Prints all commands descriptions"
+    },
+};
\ No newline at end of file
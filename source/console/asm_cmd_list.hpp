@@ -13,6 +13,27 @@ Command command_list[] = {
         &output,
         "<filepath> Path to binary output file"
     },
+    {
+        "-m", "--ram", 
+        0, 
+        &set_ram_size, 
+        &ram_size,
+        "<cells> RAM size required by program (suffixes K, M, G are allowed)"
+    },
+    {
+        "-p", "--precision", 
+        0, 
+        &set_precision, 
+        &precision,
+        "<units> Fixed point precision, powers of two replace divisions with shifts (default 1000)"
+    },
+    {
+        "-c", "--cell", 
+        0, 
+        &set_cell_type, 
+        &cell,
+        "<fixed32|fixed64|double> Type of numbers processor will be specialized for (default fixed32)"
+    },
     {
         "-h", "--help", 
         0, 
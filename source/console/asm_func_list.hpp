@@ -1,5 +1,8 @@
 void set_input_file(char *argv[], void *data);  ///< -i parser
 void set_output_file(char *argv[], void *data); ///< -o parser
+void set_ram_size(char *argv[], void *data);    ///< -m parser
+void set_precision(char *argv[], void *data);   ///< -p parser
+void set_cell_type(char *argv[], void *data);   ///< -c parser
 void show_help(char *argv[], void *data);       ///< -h parser
 
 
@@ -29,6 +32,53 @@ void set_output_file(char *argv[], void *data) {
 }
 
 
+void set_ram_size(char *argv[], void *data) {
+    if (*(++argv)) {
+        size_t size = memory_parse_size(*argv);
+
+        if (size)
+            *(size_t *)(data) = size;
+        else
+            printf("Invalid RAM size %s, argument ignored!\n", *argv);
+    }
+    else {
+        printf("No size after -m, argument ignored!\n");
+    }
+}
+
+
+void set_precision(char *argv[], void *data) {
+    if (*(++argv)) {
+        int precision = atoi(*argv);
+
+        if (precision > 0)
+            *(int *)(data) = precision;
+        else
+            printf("Invalid precision %s, argument ignored!\n", *argv);
+    }
+    else {
+        printf("No precision after -p, argument ignored!\n");
+    }
+}
+
+
+void set_cell_type(char *argv[], void *data) {
+    if (*(++argv)) {
+        if (!strcmp(*argv, "fixed32"))
+            *(int *)(data) = CELL_FIXED32;
+        else if (!strcmp(*argv, "fixed64"))
+            *(int *)(data) = CELL_FIXED64;
+        else if (!strcmp(*argv, "double"))
+            *(int *)(data) = CELL_DOUBLE;
+        else
+            printf("Unknown cell type %s, argument ignored!\n", *argv);
+    }
+    else {
+        printf("No cell type after -c, argument ignored!\n");
+    }
+}
+
+
 void show_help(char *argv[], void *data) {
     size_t i = 0;
 
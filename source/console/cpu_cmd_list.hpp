@@ -6,6 +6,188 @@ Command command_list[] = {
         &input,
         "<filepath> Path to binary file for execution"
     },
+    {
+        "-ci", "--channel-input", 
+        0, 
+        &set_channel_input, 
+        io,
+        "<channel> <text|bin> <filepath> Binds channel input to the file"
+    },
+    {
+        "-co", "--channel-output", 
+        0, 
+        &set_channel_output, 
+        io,
+        "<channel> <text|bin> <filepath> Binds channel output to the file"
+    },
+    {
+        "-m", "--ram", 
+        0, 
+        &set_ram_size, 
+        &ram_size,
+        "<cells> RAM size (suffixes K, M, G are allowed), overrides size from binary file"
+    },
+    {
+        "-sw", "--screen-width", 
+        0, 
+        &set_screen_side, 
+        &screen_width,
+        "<cells> Screen width for SHOW"
+    },
+    {
+        "-sh", "--screen-height", 
+        0, 
+        &set_screen_side, 
+        &screen_height,
+        "<cells> Screen height for SHOW"
+    },
+    {
+        "-f", "--frames", 
+        0, 
+        &set_frames_file, 
+        &frames_file,
+        "<filepath> Writes SHOW frames to the file or pipe (- for stdout) instead of terminal"
+    },
+    {
+        "-ff", "--frames-format", 
+        0, 
+        &set_frames_format, 
+        &frames_format,
+        "<ppm|raw> Frame format: binary PPM with 0xRRGGBB cells or raw cells"
+    },
+    {
+        "-fr", "--frames-rate", 
+        0, 
+        &set_frames_rate, 
+        &frames_rate,
+        "<fps> Maximum frames per second, extra frames are dropped"
+    },
+    {
+        "-t", "--trace", 
+        0, 
+        &set_output_file, 
+        &trace_file,
+        "<filepath> Records executed instructions and writes them to the file on exit or SIGUSR1"
+    },
+    {
+        "-ts", "--trace-size", 
+        0, 
+        &set_trace_size, 
+        &trace_size,
+        "<count> Number of last instructions kept in trace"
+    },
+    {
+        "-r", "--register", 
+        0, 
+        &set_flag, 
+        &regvm,
+        "Compiles stack code into register code at load time and executes it"
+    },
+    {
+        "-b", "--blocks", 
+        0, 
+        &set_flag, 
+        &blocks,
+        "Splits code into basic blocks at load time and dispatches them at once"
+    },
+    {
+        "-j", "--jit", 
+        0, 
+        &set_flag, 
+        &jit,
+        "Executes register code and compiles hot loops into native code (ignored with -t)"
+    },
+    {
+        "-w", "--workers", 
+        0, 
+        &set_count, 
+        &workers,
+        "<count> Threads that execute PARFOR (hardware thread count by default)"
+    },
+    {
+        "-wc", "--worker-chunk", 
+        0, 
+        &set_worker_chunk, 
+        &chunk,
+        "<count> Indexes taken by PARFOR worker at once (0 by default splits range into equal parts)"
+    },
+    {
+        "-gt", "--green-threads", 
+        0, 
+        &set_count, 
+        &green_threads,
+        "<count> Threads that execute green processes started by GO (hardware thread count by default)"
+    },
+    {
+        "-gq", "--green-quantum", 
+        0, 
+        &set_count, 
+        &quantum,
+        "<count> Instructions executed by green process before switch to the next one"
+    },
+    {
+        "-gm", "--green-ram", 
+        0, 
+        &set_ram_size, 
+        &green_ram_size,
+        "<cells> Gives every green process private RAM of this size (suffixes K, M, G are allowed)"
+    },
+    {
+        "-mc", "--message-capacity", 
+        0, 
+        &set_count, 
+        &message_capacity,
+        "<cells> Capacity of every message channel for SEND and RECV"
+    },
+    {
+        "-s", "--snapshot", 
+        0, 
+        &set_snapshot_file, 
+        &snapshot_file,
+        "<filepath> File where SNAPSHOT writes process state (SNAPSHOT does nothing without it)"
+    },
+    {
+        "-rs", "--restore", 
+        0, 
+        &set_input_file, 
+        &restore_file,
+        "<filepath> Continues process from snapshot instead of starting binary file (-i is optional)"
+    },
+    {
+        "-pc", "--pure-cache", 
+        0, 
+        &set_count, 
+        &pure_size,
+        "<count> Entries in cache of pure routine calls (routines that start with PURE)"
+    },
+    {
+        "-hs", "--heap-size", 
+        0, 
+        &set_ram_size, 
+        &heap_size,
+        "<cells> Adds heap of this size after RAM of program for ALLOC and FREE (suffixes K, M, G are allowed)"
+    },
+    {
+        "-hp", "--huge-pages", 
+        0, 
+        &set_flag, 
+        &huge,
+        "Asks system to back RAM with huge pages (fewer TLB misses for large RAM)"
+    },
+    {
+        "-d", "--daemon", 
+        0, 
+        &set_server_file, 
+        &server_file,
+        "<socket> Keeps running and executes programs loaded over Unix socket (other options apply to every program)"
+    },
+    {
+        "-dw", "--daemon-workers", 
+        0, 
+        &set_count, 
+        &server_workers,
+        "<count> Threads that execute daemon requests (hardware thread count by default)"
+    },
     {
         "-h", "--help", 
         0, 
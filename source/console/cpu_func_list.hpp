@@ -1,5 +1,19 @@
-void set_input_file(char *argv[], void *data);  ///< -i parser
-void show_help(char *argv[], void *data);       ///< -h parser
+void set_input_file(char *argv[], void *data);     ///< -i and -rs parser
+void set_channel_input(char *argv[], void *data);  ///< -ci parser
+void set_channel_output(char *argv[], void *data); ///< -co parser
+void set_ram_size(char *argv[], void *data);       ///< -m, -gm and -hs parser
+void set_screen_side(char *argv[], void *data);    ///< -sw and -sh parser
+void set_frames_file(char *argv[], void *data);    ///< -f parser
+void set_frames_format(char *argv[], void *data);  ///< -ff parser
+void set_frames_rate(char *argv[], void *data);    ///< -fr parser
+void set_output_file(char *argv[], void *data);    ///< -t parser
+void set_snapshot_file(char *argv[], void *data);  ///< -s parser
+void set_trace_size(char *argv[], void *data);     ///< -ts parser
+void set_count(char *argv[], void *data);          ///< -w, -gt, -gq, -mc, -pc and -dw parser
+void set_worker_chunk(char *argv[], void *data);   ///< -wc parser
+void set_server_file(char *argv[], void *data);    ///< -d parser
+void set_flag(char *argv[], void *data);           ///< Parser of options without arguments
+void show_help(char *argv[], void *data);          ///< -h parser
 
 
 void set_input_file(char *argv[], void *data) {
@@ -10,11 +24,221 @@ void set_input_file(char *argv[], void *data) {
             printf("Can't open file %s!\n", *argv);
     }
     else {
-        printf("No filename after -i, argument ignored!\n");
+        printf("No filename after %s, argument ignored!\n", *(argv - 1));
     }
 }
 
 
+/**
+ * \brief Parses channel number, mode and opens file
+ * \param [in]  argv Arguments after option
+ * \param [out] mode Channel mode
+ * \param [in]  flags File open flags
+ * \param [out] file Opened file descriptor
+ * \return Channel number or -1 on error
+*/
+static int parse_channel(char *argv[], int *mode, int flags, int *file) {
+    if (!argv[0] || !argv[1] || !argv[2]) {
+        printf("Expected channel, mode and filename after %s, argument ignored!\n", *(argv - 1));
+        return -1;
+    }
+
+    int channel = atoi(argv[0]);
+
+    if (channel < 0 || channel >= IO_CHANNELS) {
+        printf("Invalid channel %s, argument ignored!\n", argv[0]);
+        return -1;
+    }
+
+    if (!strcmp(argv[1], "text"))
+        *mode = IO_TEXT;
+    else if (!strcmp(argv[1], "bin"))
+        *mode = IO_BINARY;
+    else {
+        printf("Unknown channel mode %s, argument ignored!\n", argv[1]);
+        return -1;
+    }
+
+    *file = open(argv[2], flags | O_BINARY, 00770);
+
+    if (*file == -1) {
+        printf("Can't open file %s!\n", argv[2]);
+        return -1;
+    }
+
+    return channel;
+}
+
+
+void set_channel_input(char *argv[], void *data) {
+    int mode = IO_TEXT, file = -1;
+    int channel = parse_channel(argv + 1, &mode, O_RDONLY, &file);
+
+    if (channel != -1 && io_open_input((IoChannel *)(data) + channel, file, mode))
+        printf("Can't bind channel %i input!\n", channel);
+}
+
+
+void set_channel_output(char *argv[], void *data) {
+    int mode = IO_TEXT, file = -1;
+    int channel = parse_channel(argv + 1, &mode, O_WRONLY | O_CREAT | O_TRUNC, &file);
+
+    if (channel != -1 && io_open_output((IoChannel *)(data) + channel, file, mode))
+        printf("Can't bind channel %i output!\n", channel);
+}
+
+
+void set_ram_size(char *argv[], void *data) {
+    if (*(++argv)) {
+        size_t size = memory_parse_size(*argv);
+
+        if (size)
+            *(size_t *)(data) = size;
+        else
+            printf("Invalid RAM size %s, argument ignored!\n", *argv);
+    }
+    else {
+        printf("No size after %s, argument ignored!\n", *(argv - 1));
+    }
+}
+
+
+void set_screen_side(char *argv[], void *data) {
+    if (*(++argv)) {
+        unsigned int side = (unsigned int) strtoul(*argv, nullptr, 10);
+
+        if (side)
+            *(unsigned int *)(data) = side;
+        else
+            printf("Invalid screen side %s, argument ignored!\n", *argv);
+    }
+    else {
+        printf("No size after %s, argument ignored!\n", *(argv - 1));
+    }
+}
+
+
+void set_frames_file(char *argv[], void *data) {
+    if (*(++argv)) {
+        if (!strcmp(*argv, "-"))
+            *(int *)(data) = fileno(stdout);
+        else
+            *(int *)(data) = open(*argv, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 00770);
+
+        if (*(int *)(data) == -1)
+            printf("Can't open file %s!\n", *argv);
+    }
+    else {
+        printf("No filename after -f, argument ignored!\n");
+    }
+}
+
+
+void set_frames_format(char *argv[], void *data) {
+    if (*(++argv)) {
+        if (!strcmp(*argv, "ppm"))
+            *(int *)(data) = FRAMES_PPM;
+        else if (!strcmp(*argv, "raw"))
+            *(int *)(data) = FRAMES_RAW;
+        else
+            printf("Unknown frame format %s, argument ignored!\n", *argv);
+    }
+    else {
+        printf("No format after -ff, argument ignored!\n");
+    }
+}
+
+
+void set_frames_rate(char *argv[], void *data) {
+    if (*(++argv)) {
+        *(unsigned int *)(data) = (unsigned int) strtoul(*argv, nullptr, 10);
+    }
+    else {
+        printf("No rate after -fr, argument ignored!\n");
+    }
+}
+
+
+void set_output_file(char *argv[], void *data) {
+    if (*(++argv)) {
+        *(int *)(data) = open(*argv, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 00770);
+
+        if (*(int *)(data) == -1)
+            printf("Can't open file %s!\n", *argv);
+    }
+    else {
+        printf("No filename after %s, argument ignored!\n", *(argv - 1));
+    }
+}
+
+
+// Snapshot file isn't truncated until SNAPSHOT writes it, so it can't destroy snapshot that -rs reads
+void set_snapshot_file(char *argv[], void *data) {
+    if (*(++argv)) {
+        *(int *)(data) = open(*argv, O_WRONLY | O_CREAT | O_BINARY, 00770);
+
+        if (*(int *)(data) == -1)
+            printf("Can't open file %s!\n", *argv);
+    }
+    else {
+        printf("No filename after %s, argument ignored!\n", *(argv - 1));
+    }
+}
+
+
+void set_trace_size(char *argv[], void *data) {
+    if (*(++argv)) {
+        size_t size = strtoul(*argv, nullptr, 10);
+
+        if (size)
+            *(size_t *)(data) = size;
+        else
+            printf("Invalid trace size %s, argument ignored!\n", *argv);
+    }
+    else {
+        printf("No count after -ts, argument ignored!\n");
+    }
+}
+
+
+void set_count(char *argv[], void *data) {
+    if (*(++argv)) {
+        size_t count = strtoul(*argv, nullptr, 10);
+
+        if (count)
+            *(size_t *)(data) = count;
+        else
+            printf("Invalid count %s, argument ignored!\n", *argv);
+    }
+    else {
+        printf("No count after %s, argument ignored!\n", *(argv - 1));
+    }
+}
+
+
+void set_worker_chunk(char *argv[], void *data) {
+    if (*(++argv)) {
+        *(size_t *)(data) = strtoul(*argv, nullptr, 10);
+    }
+    else {
+        printf("No count after -wc, argument ignored!\n");
+    }
+}
+
+
+void set_server_file(char *argv[], void *data) {
+    if (*(++argv))
+        *(const char **)(data) = *argv;
+    else
+        printf("No socket path after -d, argument ignored!\n");
+}
+
+
+void set_flag(char *argv[], void *data) {
+    *(int *)(data) = 1;
+}
+
+
 void show_help(char *argv[], void *data) {
     size_t i = 0;
 
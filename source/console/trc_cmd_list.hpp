@@ -0,0 +1,16 @@
+Command command_list[] = {
+    {
+        "-i", "--input", 
+        0, 
+        &set_input_file, 
+        &input,
+        "<filepath> Path to trace file written by cpu.exe"
+    },
+    {
+        "-h", "--help", 
+        0, 
+        &show_help, 
+        &command_list,
+        "Prints all commands descriptions"
+    },
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+/**
+ * \file
+ * \brief Command decoding shared by load-time compilers and translator
+*/
+
+
+/// Command mark bits set by blocks_mark()
+typedef enum {
+    MARK_BLOCK   = 1, ///< Command starts basic block
+    MARK_COMMAND = 2, ///< Command starts at this offset
+} BLOCK_MARKS;
+
+
+/**
+ * \brief Returns size of command arguments
+ * \param [in] code Command code
+ * \param [in] flags Argument bits
+*/
+template <typename cell_t>
+static size_t command_args_size(unsigned int code, cmd_t flags) {
+    size_t src = (flags & BIT_CONST) ? sizeof(cell_t) : sizeof(arg_t);
+
+    switch (code) {
+        case CMD_PUSH: case CMD_POP:
+            return ((flags & BIT_CONST) ? sizeof(cell_t) : 0) + ((flags & BIT_REG) ? sizeof(arg_t) : 0);
+
+        case CMD_JMP: case CMD_CALL: case CMD_SPAWN: case CMD_GO: case CMD_NCALL:
+            return sizeof(arg_t);
+
+        case CMD_JB: case CMD_JA: case CMD_JE: case CMD_JNE: case CMD_JAE: case CMD_JBE:
+            return (flags & BIT_REG) ? sizeof(arg_t) + src + sizeof(arg_t) : sizeof(arg_t);
+
+        case CMD_ADD: case CMD_SUB: case CMD_MUL: case CMD_DIV:
+            return (flags & BIT_REG) ? sizeof(arg_t) + src : 0;
+
+        case CMD_INC: case CMD_DEC: case CMD_FORK:
+            return sizeof(arg_t);
+
+        case CMD_MOV:
+            return sizeof(arg_t) + src;
+
+        case CMD_PARFOR:
+            return sizeof(arg_t) + src + sizeof(arg_t);
+
+        case CMD_PURE:
+            return PURE_ARGS;
+
+        default:
+            return 0;
+    }
+}
+
+
+/**
+ * \brief Checks if command has jump target as its last argument
+ * \param [in] code Command code
+*/
+static int command_is_jump(unsigned int code) {
+    switch (code) {
+        case CMD_JMP: case CMD_CALL:
+        case CMD_JB: case CMD_JA: case CMD_JE: case CMD_JNE: case CMD_JAE: case CMD_JBE:
+            return 1;
+
+        default:
+            return 0;
+    }
+}
+
+
+/**
+ * \brief Checks if call target starts with PURE
+ * \param [in] code Process code
+ * \param [in] count Code size
+ * \param [in] target Call target
+ * \return PURE arguments or nullptr if routine is not pure
+*/
+inline const cmd_t *command_pure(const cmd_t *code, size_t count, arg_t target) {
+    if (target < 0 || (size_t) target + 2 + PURE_ARGS > count) return nullptr;
+
+    const cmd_t *cmd = code + target;
+    unsigned int command = *cmd & CMD_MASK;
+    size_t size = 1;
+
+    if (command == CMD_EXT)
+        command += cmd[size++];
+
+    return (command == CMD_PURE) ? cmd + size : nullptr;
+}
+
+
+/**
+ * \brief Marks command and block starts
+ * \param [in]  code Process code
+ * \param [in]  count Code size
+ * \param [out] marks Array of count + 1 BLOCK_MARKS combinations (must be zeroed)
+ * \return Number of commands
+*/
+template <typename cell_t>
+static size_t blocks_mark(const cmd_t *code, size_t count, cmd_t *marks) {
+    size_t commands = 0;
+
+    marks[0] |= MARK_BLOCK;
+
+    for(size_t offset = 0; offset < count; commands++) {
+        cmd_t cmd = code[offset];
+        unsigned int command = cmd & CMD_MASK;
+        size_t size = 1;
+
+        if (command == CMD_EXT)
+            command += code[offset + size++];
+
+        size += command_args_size<cell_t>(command, (cmd_t)(cmd & ~CMD_MASK));
+
+        marks[offset] |= MARK_COMMAND;
+
+        int jump = command_is_jump(command);
+
+        if (jump && offset + size <= count) {
+            arg_t target = *((const arg_t *)(code + offset + size - sizeof(arg_t)));
+
+            if (target > -1 && (size_t) target < count)
+                marks[target] |= MARK_BLOCK;
+        }
+
+        if ((jump || command == CMD_RET || command == CMD_HLT || command == CMD_SNAPSHOT) && offset + size <= count)
+            marks[offset + size] |= MARK_BLOCK;
+
+        offset += size;
+    }
+
+    return commands;
+}
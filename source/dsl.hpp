@@ -10,7 +10,7 @@
  * \brief Creates variable and pops value from stack into it
 */
 #define POP_(var)                                                               \
-    int var = 0;                                                                \
+    cell_t var = 0;                                                                \
     ASSERT_IP(!stack_pop(stack, &var), "Empty stack pop!", OFFSET(ip - 1));     \
     do {} while(0)
 
@@ -19,9 +19,9 @@
  * \brief Sets ip to its argument
 */
 #define JMP_()                                                                  \
-    arg = *((arg_t *)(ip));                                                     \
-    ASSERT_IP(arg > -1, "Jump to -1!", OFFSET(ip - 1));                         \
-    ip = process -> code + arg;                                                 \
+    arg_t target = *((const arg_t *)(ip));                                      \
+    ASSERT_IP(target > -1, "Jump to -1!", OFFSET(ip - 1));                      \
+    ip = process -> code + target;                                              \
     do {} while(0)
 
 
@@ -56,7 +56,90 @@
 /**
  * \brief Prints last stack element
 */
-#define OUT_()                                                                  \
-    POP_(value);                                                                \
-    printf("%g\n", (float) value / PRECISION);                                  \
+#define OUT_()                                                                                  \
+    POP_(value);                                                                                \
+    ASSERT_IP(io_write(process -> io, &value, 1, fixed) == 1, "Can't write value!", OFFSET(ip - 1));   \
+    do {} while(0)
+
+
+
+/**
+ * \brief Creates variable and pops cell count into it (converted to integer)
+*/
+#define POP_COUNT_(var)                                                         \
+    POP_(var##_cell);                                                           \
+    ASSERT_IP(var##_cell > -1, "Negative cell count!", OFFSET(ip - 1));         \
+    long long var = Policy::to_int(var##_cell, fixed);                          \
+    do {} while(0)
+
+
+/**
+ * \brief Converts address to RAM pointer and checks that count cells fit in RAM
+*/
+#define RANGE_(ptr, addr, count)                                                                                    \
+    ASSERT_IP(addr > -1 && (size_t) Policy::to_int(addr, fixed) + (size_t) count <= process -> ram_size,            \
+              "Segmentation fault! Wrong RAM range!", OFFSET(ip - 1));                                              \
+    cell_t *ptr = ram + Policy::to_int(addr, fixed);                                                                \
+    do {} while(0)
+
+
+/**
+ * \brief Creates channel pointer and pops channel number into it
+*/
+#define POP_CHANNEL_(var)                                                                       \
+    POP_(var##_cell);                                                                           \
+    long long var##_index = Policy::to_int(var##_cell, fixed);                                  \
+    ASSERT_IP(var##_index > -1 && var##_index < IO_CHANNELS, "Wrong channel!", OFFSET(ip - 1)); \
+    IoChannel *var = process -> io + var##_index;                                               \
+    do {} while(0)
+
+
+/**
+ * \brief Creates message channel pointer and pops channel number into it
+*/
+#define POP_MESSAGES_(var)                                                                          \
+    POP_(var##_cell);                                                                               \
+    long long var##_index = Policy::to_int(var##_cell, fixed);                                      \
+    ASSERT_IP(var##_index > -1 && var##_index < MSG_CHANNELS, "Wrong message channel!", OFFSET(ip - 1)); \
+    MessageChannel *var = process -> messages + var##_index;                                        \
+    do {} while(0)
+
+
+/**
+ * \brief Green process gives its thread to others and executes command without arguments again later
+*/
+#define REPEAT_(code)                                                           \
+    process -> ip = ip - (((code) >= CMD_EXT) ? 2 : 1);                         \
+    process -> yielded = 1;                                                     \
+    return 0;                                                                   \
+    do {} while(0)
+
+
+/**
+ * \brief Creates variable and reads destination register index into it
+*/
+#define REG_OPERAND_(var)                                                       \
+    arg_t var = *((const arg_t *)(ip));                                         \
+    ip += sizeof(arg_t);                                                        \
+    ASSERT_IP(var > -1 && var < (int) REGISTER_SIZE,                            \
+              "Segmentation fault! Wrong register index!", OFFSET(ip - 1));     \
+    do {} while(0)
+
+
+/**
+ * \brief Creates variable and reads source operand into it (constant if BIT_CONST is set, register otherwise)
+*/
+#define SRC_OPERAND_(var)                                                       \
+    cell_t var = 0;                                                             \
+    if (cmd & BIT_CONST) {                                                      \
+        var = *((const cell_t *)(ip));                                          \
+        ip += sizeof(cell_t);                                                   \
+    }                                                                           \
+    else {                                                                      \
+        arg_t index_ = *((const arg_t *)(ip));                                  \
+        ip += sizeof(arg_t);                                                    \
+        ASSERT_IP(index_ > -1 && index_ < (int) REGISTER_SIZE,                  \
+                  "Segmentation fault! Wrong register index!", OFFSET(ip - 1)); \
+        var = reg[index_];                                                      \
+    }                                                                           \
     do {} while(0)
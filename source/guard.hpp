@@ -0,0 +1,258 @@
+/**
+ * \file
+ * \brief Guard pages: in GUARD_PAGES build RAM lies at the beginning of reserved range without access,
+ * so PUSH and POP with memory argument don't check index and wrong access is stopped by SIGSEGV handler
+ * \note Index is masked by the reserved range once per access, negative index lands on guard pages
+ * (index that is wrong by a multiple of the range wraps into RAM)
+ * \note RAM of every process is one mapping with registers in the cache line before RAM
+ * \note Include it after Process
+*/
+
+
+/// Bytes of registers that lie right before RAM in the same mapping (one cache line)
+const size_t ARENA_REGISTERS = 64;
+
+static_assert(REGISTER_SIZE * sizeof(long long) <= ARENA_REGISTERS, "Registers don't fit in cache line!");
+
+
+/// Returns registers of RAM reserved by ram_map() (the last cache line that ends before RAM)
+static char *arena_registers(void *ram) {
+    return (char *)(((size_t) ram - ARENA_REGISTERS) & ~(ARENA_REGISTERS - 1));
+}
+
+
+/// Returns registers that lie before RAM reserved by ram_map()
+template <typename cell_t>
+cell_t *ram_registers(cell_t *ram) {
+    return (cell_t *) arena_registers(ram);
+}
+
+
+/// Zeroes registers and RAM reserved by ram_map() in time that doesn't depend on RAM size
+template <typename cell_t>
+int ram_reset(cell_t *ram, size_t size) {
+    char *reg = arena_registers(ram);
+
+    return memory_reset(reg, (size_t)((char *)(ram + size) - reg));
+}
+
+
+#ifdef GUARD_PAGES
+
+#if !defined(__linux__)
+    #error "Guard pages are supported only on Linux!"
+#endif
+
+#include <setjmp.h>
+
+
+/// RAM size in cells must be less than it
+const size_t GUARD_CELLS = 1ull << 32;
+
+
+/// Execution loop that is stopped by access to guard page
+typedef struct GuardFrame {
+    sigjmp_buf env;                     ///< Return point of the loop
+    const char *start = nullptr;        ///< Reserved range start (guard page before RAM)
+    const char *end = nullptr;          ///< Reserved range end
+    struct GuardFrame *outer = nullptr; ///< Loop that executes this one
+} GuardFrame;
+
+
+/// Innermost execution loop of this thread
+static thread_local GuardFrame *GUARD_FRAME = nullptr;
+
+
+/**
+ * \brief Returns from execution loop if fault address is in its RAM, otherwise lets fault crash process
+ * \param [in] sig Signal
+ * \param [in] info Fault information
+ * \param [in] context Unused
+*/
+static void guard_signal(int sig, siginfo_t *info, void *context) {
+    GuardFrame *frame = GUARD_FRAME;
+    const char *address = (const char *) info -> si_addr;
+
+    if (frame && address >= frame -> start && address < frame -> end)
+        siglongjmp(frame -> env, 1);
+
+    signal(sig, SIG_DFL);
+}
+
+
+int guard_install() {
+    struct sigaction action = {};
+
+    action.sa_sigaction = guard_signal;
+    action.sa_flags = SA_SIGINFO | SA_NODEFER;
+    sigemptyset(&action.sa_mask);
+
+    return sigaction(SIGSEGV, &action, nullptr);
+}
+
+
+/**
+ * \brief Returns cells reserved for RAM (any index after clamp lies in this range)
+ * \param [in] size RAM size in cells (not zero)
+ * \return The smallest power of two that is greater than size
+*/
+inline size_t guard_cells(size_t size) {
+    return 1ull << (64 - __builtin_clzll(size));
+}
+
+
+/**
+ * \brief Returns mask that keeps RAM index in reserved range (computed once when RAM is reserved)
+ * \param [in] size RAM size in cells
+ * \return guard_cells(size) - 1
+*/
+inline size_t ram_mask(size_t size) {
+    return guard_cells(size) - 1;
+}
+
+
+/**
+ * \brief Executes loop and turns guard page fault into its error
+ * \param [in] process Process that loop executes
+ * \param [in] loop Function that executes process
+ * \return Non zero value means error
+*/
+template <typename Policy, typename Loop>
+int guard_run(const Process<Policy> *process, Loop loop) {
+    GuardFrame frame = {};
+
+    size_t page = memory_page_size();
+
+    const char *reg = arena_registers(process -> ram);
+    size_t arena = (size_t)((const char *)(process -> ram + process -> ram_size) - reg);
+
+    frame.start = reg - page - (page - arena % page) % page;
+    frame.end = (const char *)(process -> ram + guard_cells(process -> ram_size));
+    frame.outer = GUARD_FRAME;
+
+    GUARD_FRAME = &frame;
+
+    if (sigsetjmp(frame.env, 0)) {
+        GUARD_FRAME = frame.outer;
+
+        printf("Segmentation fault! Wrong RAM index!\n");
+
+        return 1;
+    }
+
+    int error = loop();
+
+    GUARD_FRAME = frame.outer;
+
+    return error;
+}
+
+
+/// Returns bytes from registers to the end of RAM (RAM ends at page boundary, so registers are followed by gap up to cache line)
+static size_t arena_size(size_t size, size_t cell) {
+    return (2 * ARENA_REGISTERS + size * cell - 1) / ARENA_REGISTERS * ARENA_REGISTERS;
+}
+
+
+/**
+ * \brief Reserves registers and RAM followed by guard pages
+ * \param [in] size RAM size in cells
+ * \param [in] cell Cell size in bytes
+ * \param [in] huge Ask system to back RAM with huge pages
+ * \return RAM or nullptr on error
+*/
+static void *arena_map(size_t size, size_t cell, int huge) {
+    if (!size || size >= GUARD_CELLS) return nullptr;
+
+    size_t arena = arena_size(size, cell);
+    char *reg = (char *) memory_map_guarded(arena, arena - size * cell + guard_cells(size) * cell);
+
+    if (reg && huge) memory_huge(reg, arena);
+
+    return (reg) ? reg + arena - size * cell : nullptr;
+}
+
+
+/**
+ * \brief Releases registers and RAM reserved by arena_map()
+ * \param [in] ram RAM
+ * \param [in] size RAM size in cells
+ * \param [in] cell Cell size in bytes
+ * \return Non zero value means error
+*/
+static int arena_unmap(void *ram, size_t size, size_t cell) {
+    size_t arena = arena_size(size, cell);
+
+    return memory_unmap_guarded(arena_registers(ram), arena, arena - size * cell + guard_cells(size) * cell);
+}
+
+
+/// Checks RAM index of command at offset (guard pages check it instead)
+#define RAM_INDEX_(index, offset)   \
+    index &= (long long) process -> ram_mask;
+
+#else
+
+/// Executes loop
+template <typename Policy, typename Loop>
+int guard_run(const Process<Policy> *process, Loop loop) {
+    return loop();
+}
+
+
+/**
+ * \brief Reserves page with registers at its end followed by RAM (RAM is aligned to page, so snapshot can be mapped to it)
+ * \param [in] size RAM size in cells
+ * \param [in] cell Cell size in bytes
+ * \param [in] huge Ask system to back RAM with huge pages
+ * \return RAM or nullptr on error
+*/
+static void *arena_map(size_t size, size_t cell, int huge) {
+    size_t page = memory_page_size();
+    char *arena = (char *) memory_map(page + size * cell);
+
+    if (arena && huge) memory_huge(arena, page + size * cell);
+
+    return (arena) ? arena + page : nullptr;
+}
+
+
+/**
+ * \brief Releases registers and RAM reserved by arena_map()
+ * \param [in] ram RAM
+ * \param [in] size RAM size in cells
+ * \param [in] cell Cell size in bytes
+ * \return Non zero value means error
+*/
+static int arena_unmap(void *ram, size_t size, size_t cell) {
+    size_t page = memory_page_size();
+
+    return memory_unmap((char *) ram - page, page + size * cell);
+}
+
+
+/// Returns mask of RAM index (unused, index is checked by RAM_INDEX_)
+inline size_t ram_mask(size_t size) {
+    return size - 1;
+}
+
+
+/// Checks RAM index of command at offset
+#define RAM_INDEX_(index, offset)   \
+    ASSERT_IP(index > -1 && (size_t) index < process -> ram_size, "Segmentation fault! Wrong RAM index!", offset);
+
+#endif
+
+
+/// Reserves registers and RAM
+template <typename cell_t>
+cell_t *ram_map(size_t size, int huge) {
+    return (cell_t *) arena_map(size, sizeof(cell_t), huge);
+}
+
+
+/// Releases registers and RAM reserved by ram_map()
+template <typename cell_t>
+int ram_unmap(cell_t *ram, size_t size) {
+    return arena_unmap(ram, size, sizeof(cell_t));
+}
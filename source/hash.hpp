@@ -25,4 +25,38 @@ typedef enum {
     CMD_IN_HASH = 5863484,
     CMD_SHOW_HASH = 6385690694,
     CMD_CLR_HASH = 193488486,
+    CMD_FILL_HASH = 6385224492,
+    CMD_COPY_HASH = 6385123360,
+    CMD_VADD_HASH = 6385790500,
+    CMD_VSUB_HASH = 6385810661,
+    CMD_VMUL_HASH = 6385804137,
+    CMD_VDOT_HASH = 6385794146,
+    CMD_VSUM_HASH = 6385810672,
+    CMD_VMIN_HASH = 6385803743,
+    CMD_VMAX_HASH = 6385803489,
+    CMD_READ_HASH = 6385651009,
+    CMD_WRITE_HASH = 210732889424,
+    CMD_INC_HASH = 193495071,
+    CMD_DEC_HASH = 193489329,
+    CMD_MOV_HASH = 193499479,
+    CMD_SPAWN_HASH = 210728065262,
+    CMD_JOIN_HASH = 6385374677,
+    CMD_AADD_HASH = 6385035823,
+    CMD_AXCHG_HASH = 210707007856,
+    CMD_ACAS_HASH = 6385037917,
+    CMD_PARFOR_HASH = 6953891551215,
+    CMD_GO_HASH = 5863419,
+    CMD_YIELD_HASH = 210734933212,
+    CMD_SEND_HASH = 6385687375,
+    CMD_RECV_HASH = 6385651093,
+    CMD_TRYSEND_HASH = 229484261121358,
+    CMD_TRYRECV_HASH = 229484261085076,
+    CMD_SENDN_HASH = 210727683485,
+    CMD_RECVN_HASH = 210726486179,
+    CMD_SNAPSHOT_HASH = 7572931890379829,
+    CMD_FORK_HASH = 6385231223,
+    CMD_PURE_HASH = 6385597121,
+    CMD_NCALL_HASH = 210721668111,
+    CMD_ALLOC_HASH = 210706586640,
+    CMD_FREE_HASH = 6385234055,
 } COMMANDS_HASH;
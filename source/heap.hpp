@@ -0,0 +1,314 @@
+/**
+ * \file
+ * \brief Heap: ALLOC gives out RAM block after static RAM and FREE takes it back, block size is rounded up to power of two
+ * \note Every size class has free list shared by all threads of program and small cache in every thread
+ * \note Block state is kept outside RAM, so FREE of wrong address is found and broken free list is noticed
+ * \note Include it after Process
+*/
+
+
+/// Smallest block is 2^HEAP_MIN_CLASS cells (free block keeps link in its first 8 bytes)
+const unsigned int HEAP_MIN_CLASS = 1;
+
+/// Size class count (the largest block is 2^(HEAP_CLASSES - 1) cells)
+const unsigned int HEAP_CLASSES = 32;
+
+/// Blocks of one class kept by thread cache
+const size_t HEAP_CACHE = 16;
+
+
+/// Block state in heap map (low bits keep size class)
+typedef enum {
+    HEAP_USED = 0x40,   ///< Block is given by ALLOC
+    HEAP_FREE = 0x80,   ///< Block is in free list or thread cache
+} HEAP_STATES;
+
+
+/// Heap shared by all threads of program
+template <typename cell_t>
+struct Heap {
+    Monitor monitor = {};                   ///< Protects free lists and top
+    size_t id = 0;                          ///< Unique heap number (thread caches of other heaps are dropped)
+    cell_t *ram = nullptr;                  ///< Process RAM
+    size_t start = 0;                       ///< First heap cell in RAM
+    size_t size = 0;                        ///< Heap size in cells
+    size_t top = 0;                         ///< Cells cut from heap for blocks
+    unsigned char *map = nullptr;           ///< State of block starting at every 2^HEAP_MIN_CLASS cells (0 inside block)
+    long long lists[HEAP_CLASSES] = {};     ///< First free block of every class (-1 for empty list)
+    size_t allocs = 0;                      ///< ALLOC count
+    size_t frees = 0;                       ///< FREE count
+    size_t asked = 0;                       ///< Cells asked by all ALLOC
+    size_t given = 0;                       ///< Cells given by all ALLOC
+    size_t used = 0;                        ///< Cells in blocks that are not freed
+    size_t peak = 0;                        ///< The largest used
+};
+
+
+/// Free blocks kept by one thread
+typedef struct {
+    size_t id = 0;                                      ///< Heap that blocks belong to
+    size_t count[HEAP_CLASSES] = {};                    ///< Block count of every class
+    long long blocks[HEAP_CLASSES][HEAP_CACHE] = {};    ///< Block offsets from heap start
+} HeapCache;
+
+
+/// Cache of this thread
+static thread_local HeapCache HEAP_THREAD = {};
+
+/// The last given heap number
+static size_t HEAP_ID = 0;
+
+
+/**
+ * \brief Creates heap
+ * \param [out] heap Heap to create
+ * \param [in]  ram Process RAM
+ * \param [in]  start First heap cell in RAM
+ * \param [in]  size Heap size in cells
+ * \return Non zero value means error
+*/
+template <typename cell_t>
+int heap_constructor(Heap<cell_t> *heap, cell_t *ram, size_t start, size_t size) {
+    ASSERT(heap && ram && size, "Invalid heap!");
+
+    heap -> map = (unsigned char *) memory_map(size >> HEAP_MIN_CLASS);
+
+    ASSERT(heap -> map, "Can't allocate heap map!");
+
+    if (monitor_constructor(&heap -> monitor)) {
+        memory_unmap(heap -> map, size >> HEAP_MIN_CLASS);
+        heap -> map = nullptr;
+        return 1;
+    }
+
+    heap -> id = __atomic_add_fetch(&HEAP_ID, 1, __ATOMIC_SEQ_CST);
+    heap -> ram = ram;
+    heap -> start = start;
+    heap -> size = size;
+
+    for(unsigned int i = 0; i < HEAP_CLASSES; i++)
+        heap -> lists[i] = -1;
+
+    return 0;
+}
+
+
+/**
+ * \brief Frees heap (blocks kept by thread caches are dropped with it)
+ * \param [in] heap Heap to free
+*/
+template <typename cell_t>
+void heap_destructor(Heap<cell_t> *heap) {
+    if (!heap -> map) return;
+
+    memory_unmap(heap -> map, heap -> size >> HEAP_MIN_CLASS);
+
+    monitor_destructor(&heap -> monitor);
+
+    *heap = {};
+}
+
+
+/// Reads link to the next free block
+template <typename cell_t>
+static long long heap_link(const Heap<cell_t> *heap, long long block) {
+    long long next = 0;
+
+    memcpy(&next, heap -> ram + heap -> start + block, sizeof(next));
+
+    return next;
+}
+
+
+/// Writes link to the next free block
+template <typename cell_t>
+static void heap_set_link(Heap<cell_t> *heap, long long block, long long next) {
+    memcpy(heap -> ram + heap -> start + block, &next, sizeof(next));
+}
+
+
+/// Checks that block is free block of class
+template <typename cell_t>
+static int heap_is_free(const Heap<cell_t> *heap, long long block, unsigned int size_class) {
+    return block > -1 && (size_t) block < heap -> top && !(block & ((1 << HEAP_MIN_CLASS) - 1)) &&
+           __atomic_load_n(heap -> map + (block >> HEAP_MIN_CLASS), __ATOMIC_RELAXED) == (HEAP_FREE | size_class);
+}
+
+
+/**
+ * \brief Returns cache of this thread for heap (blocks of other heap are dropped)
+ * \param [in] heap Heap
+*/
+template <typename cell_t>
+static HeapCache *heap_cache(const Heap<cell_t> *heap) {
+    HeapCache *cache = &HEAP_THREAD;
+
+    if (cache -> id != heap -> id) {
+        *cache = {};
+        cache -> id = heap -> id;
+    }
+
+    return cache;
+}
+
+
+/**
+ * \brief Gives block from thread cache, free list or the rest of heap
+ * \param heap Heap
+ * \param [in]  count Cells asked by ALLOC
+ * \param [out] index RAM index of block (-1 if heap is exhausted)
+ * \return Non zero value means that free list is broken
+*/
+template <typename cell_t>
+int heap_alloc(Heap<cell_t> *heap, size_t count, long long *index) {
+    unsigned int size_class = HEAP_MIN_CLASS;
+
+    while (size_class < HEAP_CLASSES && (1ull << size_class) < count) size_class++;
+
+    *index = -1;
+
+    if (size_class == HEAP_CLASSES) return 0;
+
+    HeapCache *cache = heap_cache(heap);
+
+    size_t *cached = cache -> count + size_class;
+    long long block = -1;
+
+    if (*cached)
+        block = cache -> blocks[size_class][--*cached];
+    else {
+        monitor_lock(&heap -> monitor);
+
+        // Thread takes half of cache at once, so lock is taken once per several ALLOC
+        while (heap -> lists[size_class] != -1 && *cached < HEAP_CACHE / 2) {
+            long long free_block = heap -> lists[size_class];
+
+            if (!heap_is_free(heap, free_block, size_class)) {
+                monitor_unlock(&heap -> monitor);
+                return 1;
+            }
+
+            heap -> lists[size_class] = heap_link(heap, free_block);
+            cache -> blocks[size_class][(*cached)++] = free_block;
+        }
+
+        if (*cached)
+            block = cache -> blocks[size_class][--*cached];
+        else if (heap -> top + (1ull << size_class) <= heap -> size) {
+            block = (long long) heap -> top;
+            heap -> top += 1ull << size_class;
+        }
+
+        monitor_unlock(&heap -> monitor);
+    }
+
+    if (block == -1) return 0;
+
+    __atomic_store_n(heap -> map + (block >> HEAP_MIN_CLASS), (unsigned char)(HEAP_USED | size_class), __ATOMIC_RELAXED);
+
+    size_t used = __atomic_add_fetch(&heap -> used, 1ull << size_class, __ATOMIC_RELAXED);
+    size_t peak = __atomic_load_n(&heap -> peak, __ATOMIC_RELAXED);
+
+    while (peak < used && !__atomic_compare_exchange_n(&heap -> peak, &peak, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+
+    __atomic_add_fetch(&heap -> allocs, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&heap -> asked, count, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&heap -> given, 1ull << size_class, __ATOMIC_RELAXED);
+
+    *index = (long long) heap -> start + block;
+
+    return 0;
+}
+
+
+/**
+ * \brief Takes block back to thread cache, cache overflow goes to free list
+ * \param heap Heap
+ * \param [in] index RAM index given by ALLOC
+ * \return Non zero value means that address is not block given by ALLOC
+*/
+template <typename cell_t>
+int heap_free(Heap<cell_t> *heap, long long index) {
+    long long block = index - (long long) heap -> start;
+
+    if (block < 0 || (block & ((1 << HEAP_MIN_CLASS) - 1))) return 1;
+
+    // Lookup and mark are done under lock, so two FREE of one block can't both take it
+    monitor_lock(&heap -> monitor);
+
+    unsigned char state = ((size_t) block < heap -> top) ? __atomic_load_n(heap -> map + (block >> HEAP_MIN_CLASS), __ATOMIC_RELAXED) : (unsigned char) HEAP_FREE;
+
+    if (state & HEAP_USED)
+        __atomic_store_n(heap -> map + (block >> HEAP_MIN_CLASS), (unsigned char)(HEAP_FREE | (state & ~HEAP_USED)), __ATOMIC_RELAXED);
+
+    monitor_unlock(&heap -> monitor);
+
+    if (!(state & HEAP_USED)) return 1;
+
+    unsigned int size_class = state & ~HEAP_USED;
+
+    __atomic_sub_fetch(&heap -> used, 1ull << size_class, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&heap -> frees, 1, __ATOMIC_RELAXED);
+
+    HeapCache *cache = heap_cache(heap);
+
+    size_t *cached = cache -> count + size_class;
+
+    if (*cached == HEAP_CACHE) {
+        monitor_lock(&heap -> monitor);
+
+        while (*cached > HEAP_CACHE / 2) {
+            long long free_block = cache -> blocks[size_class][--*cached];
+
+            heap_set_link(heap, free_block, heap -> lists[size_class]);
+            heap -> lists[size_class] = free_block;
+        }
+
+        monitor_unlock(&heap -> monitor);
+    }
+
+    cache -> blocks[size_class][(*cached)++] = block;
+
+    return 0;
+}
+
+
+/**
+ * \brief Returns blocks of this thread cache to free lists (call it before thread stops executing program)
+ * \param heap Heap (nothing is done for nullptr)
+*/
+template <typename cell_t>
+void heap_flush(Heap<cell_t> *heap) {
+    if (!heap || HEAP_THREAD.id != heap -> id) return;
+
+    HeapCache *cache = &HEAP_THREAD;
+
+    monitor_lock(&heap -> monitor);
+
+    for(unsigned int i = 0; i < HEAP_CLASSES; i++) {
+        while (cache -> count[i]) {
+            long long block = cache -> blocks[i][--cache -> count[i]];
+
+            heap_set_link(heap, block, heap -> lists[i]);
+            heap -> lists[i] = block;
+        }
+    }
+
+    monitor_unlock(&heap -> monitor);
+}
+
+
+/**
+ * \brief Prints heap statistics
+ * \param [in] heap Heap
+ * \param [in] stream Output stream
+ * \note Internal fragmentation is part of given cells that wasn't asked, external is part of cut cells that were never used at once
+*/
+template <typename cell_t>
+void heap_report(const Heap<cell_t> *heap, FILE *stream) {
+    double internal = (heap -> given) ? 100.0 * (double)(heap -> given - heap -> asked) / (double) heap -> given : 0;
+    double external = (heap -> top) ? 100.0 * (double)(heap -> top - heap -> peak) / (double) heap -> top : 0;
+
+    fprintf(stream, "Heap: %zu allocs, %zu frees, peak %zu cells, cut %zu of %zu cells, fragmentation %.1f%% internal, %.1f%% external\n",
+            heap -> allocs, heap -> frees, heap -> peak, heap -> top, heap -> size, internal, external);
+}
@@ -0,0 +1,551 @@
+/**
+ * \file
+ * \brief Tracing JIT: hot loops of register code are recorded and compiled into native code
+ * \note Native code is generated only for integer cells on x86-64 Linux, otherwise every loop stays in the interpreter
+ * \note Include it after regvm.hpp
+*/
+
+
+/// Number of backward jumps to loop head after which loop is recorded
+const int JIT_HOT_LOOP = 16;
+
+/// Maximum number of operations in one trace
+const size_t JIT_TRACE_SIZE = 256;
+
+/// Maximum size of native code of one operation
+const size_t JIT_OP_SIZE = 64;
+
+
+/// Trace compiler state
+template <typename Policy>
+struct Jit {
+    typedef typename Policy::cell_t cell_t;
+
+    /// Compiled trace (returns index of operation interpreter continues with)
+    typedef int (*function_t)(cell_t *file, Jit *jit);
+
+    Process<Policy> *process = nullptr;     ///< Process to execute
+    RegCode<cell_t> *regcode = nullptr;     ///< Register code
+
+    int *hits = nullptr;                    ///< Backward jumps to every operation (-1 means loop can't be compiled)
+    function_t *native = nullptr;           ///< Compiled trace by its loop head (nullptr if there is no trace)
+    void **memory = nullptr;                ///< Mapped native code by loop head
+    size_t *sizes = nullptr;                ///< Mapped size by loop head
+
+    int head = -1;                          ///< Loop head being recorded (-1 if nothing is recorded)
+    int trace[JIT_TRACE_SIZE] = {};         ///< Recorded operation indexes
+    size_t length = 0;                      ///< Recorded operation count
+
+    size_t compiled = 0;                    ///< Compiled trace count
+    size_t aborted = 0;                     ///< Loops that can't be compiled
+};
+
+
+/**
+ * \brief Allocates trace compiler for register code
+ * \param [out] jit Trace compiler
+ * \param [in]  process Process to execute
+ * \param [in]  regcode Compiled register code
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int jit_constructor(Jit<Policy> *jit, Process<Policy> *process, RegCode<typename Policy::cell_t> *regcode);
+
+
+/**
+ * \brief Frees native code and trace compiler
+ * \param [in] jit Trace compiler
+*/
+template <typename Policy>
+void jit_destructor(Jit<Policy> *jit);
+
+
+
+
+/// Native code is generated only for integer cells
+static int jit_native_cell(int)         { return 1; }
+static int jit_native_cell(long long)   { return 1; }
+static int jit_native_cell(double)      { return 0; }
+
+
+/// Stops recording and forbids loop compilation
+template <typename Policy>
+static void jit_abort(Jit<Policy> *jit) {
+    jit -> hits[jit -> head] = -1;
+    jit -> head = -1;
+    jit -> aborted++;
+}
+
+
+/// Runs compiled trace and returns index of operation to continue with
+template <typename Policy>
+static int jit_run(Jit<Policy> *jit, int head) {
+    return jit -> native[head](jit -> regcode -> file, jit);
+}
+
+
+#if defined(__x86_64__) && defined(__linux__)
+
+
+/// Native code buffer
+typedef struct {
+    unsigned char *code = nullptr;  ///< Code start
+    size_t size = 0;                ///< Written bytes
+} JitBuffer;
+
+
+/// x86-64 condition codes
+typedef enum {
+    X86_E  = 0x4, ///< Equal
+    X86_NE = 0x5, ///< Not equal
+    X86_S  = 0x8, ///< Negative
+    X86_NS = 0x9, ///< Not negative
+    X86_L  = 0xC, ///< Less
+    X86_GE = 0xD, ///< Greater or equal
+    X86_LE = 0xE, ///< Less or equal
+    X86_G  = 0xF, ///< Greater
+} X86_CONDITIONS;
+
+
+/// x86-64 registers used by traces
+typedef enum {
+    X86_EAX = 0,
+    X86_ECX = 1,
+    X86_EDX = 2,
+    X86_ESI = 6,
+    X86_EDI = 7,
+} X86_REGISTERS;
+
+
+/// Appends bytes to native code
+static void jit_bytes(JitBuffer *buffer, const unsigned char *bytes, size_t count) {
+    memcpy(buffer -> code + buffer -> size, bytes, count);
+    buffer -> size += count;
+}
+
+
+/// Appends 4 byte value to native code
+static void jit_int(JitBuffer *buffer, int value) {
+    jit_bytes(buffer, (const unsigned char *) &value, sizeof(int));
+}
+
+
+/// Appends 8 byte value to native code
+static void jit_pointer(JitBuffer *buffer, const void *value) {
+    jit_bytes(buffer, (const unsigned char *) &value, sizeof(void *));
+}
+
+
+/// Appends REX.W prefix for 64 bit cells
+template <typename cell_t>
+static void jit_cell_prefix(JitBuffer *buffer) {
+    const unsigned char rex_w = 0x48;
+
+    if (sizeof(cell_t) == 8)
+        jit_bytes(buffer, &rex_w, 1);
+}
+
+
+/// Moves cell between x86 register and register file ([rbx + index * cell size])
+template <typename cell_t>
+static void jit_file(JitBuffer *buffer, unsigned char opcode, int x86, int index) {
+    jit_cell_prefix<cell_t>(buffer);
+
+    const unsigned char bytes[] = {opcode, (unsigned char)(0x83 | (x86 << 3))};
+    jit_bytes(buffer, bytes, sizeof(bytes));
+
+    jit_int(buffer, index * (int) sizeof(cell_t));
+}
+
+
+/// Loads cell from register file
+template <typename cell_t>
+static void jit_load(JitBuffer *buffer, int x86, int index) {
+    jit_file<cell_t>(buffer, 0x8B, x86, index);
+}
+
+
+/// Stores cell to register file
+template <typename cell_t>
+static void jit_store(JitBuffer *buffer, int x86, int index) {
+    jit_file<cell_t>(buffer, 0x89, x86, index);
+}
+
+
+/// Applies two register instruction to eax and ecx (add, sub, cmp)
+template <typename cell_t>
+static void jit_eax_ecx(JitBuffer *buffer, unsigned char opcode) {
+    jit_cell_prefix<cell_t>(buffer);
+
+    const unsigned char bytes[] = {opcode, 0xC8};
+    jit_bytes(buffer, bytes, sizeof(bytes));
+}
+
+
+/// Tests eax (or ecx) with itself
+template <typename cell_t>
+static void jit_test(JitBuffer *buffer, int x86) {
+    jit_cell_prefix<cell_t>(buffer);
+
+    const unsigned char bytes[] = {0x85, (unsigned char)(0xC0 | (x86 << 3) | x86)};
+    jit_bytes(buffer, bytes, sizeof(bytes));
+}
+
+
+/// Calls helper with jit pointer (r12) as argument after cell arguments
+static void jit_call(JitBuffer *buffer, const void *helper, int cells) {
+    const unsigned char mov_rsi_r12[] = {0x4C, 0x89, 0xE6}, mov_rdx_r12[] = {0x4C, 0x89, 0xE2};
+    const unsigned char mov_rax[] = {0x48, 0xB8}, call_rax[] = {0xFF, 0xD0};
+
+    if (cells == 1)
+        jit_bytes(buffer, mov_rsi_r12, sizeof(mov_rsi_r12));
+    else
+        jit_bytes(buffer, mov_rdx_r12, sizeof(mov_rdx_r12));
+
+    jit_bytes(buffer, mov_rax, sizeof(mov_rax));
+    jit_pointer(buffer, helper);
+    jit_bytes(buffer, call_rax, sizeof(call_rax));
+}
+
+
+/**
+ * \brief Appends side exit that is taken unless condition is true
+ * \param buffer Native code
+ * \param [in] stay Condition to stay in trace
+ * \param [in] exit Operation index interpreter continues with
+ * \note Common epilogue is at the start of native code
+*/
+static void jit_guard(JitBuffer *buffer, int stay, int exit) {
+    const unsigned char jcc[] = {(unsigned char)(0x70 | stay), 10}, mov_eax = 0xB8, jmp = 0xE9;
+
+    jit_bytes(buffer, jcc, sizeof(jcc));
+
+    jit_bytes(buffer, &mov_eax, 1);
+    jit_int(buffer, exit);
+
+    jit_bytes(buffer, &jmp, 1);
+    jit_int(buffer, -(int)(buffer -> size + sizeof(int)));
+}
+
+
+/// Multiplication helper
+template <typename Policy>
+static typename Policy::cell_t jit_mul(typename Policy::cell_t a, typename Policy::cell_t b, Jit<Policy> *jit) {
+    return Policy::mul(a, b, &jit -> process -> fixed);
+}
+
+
+/// Division helper (divider is checked in trace)
+template <typename Policy>
+static typename Policy::cell_t jit_div(typename Policy::cell_t a, typename Policy::cell_t b, Jit<Policy> *jit) {
+    return Policy::div(a, b, &jit -> process -> fixed);
+}
+
+
+/// Square root helper (sign is checked in trace)
+template <typename Policy>
+static typename Policy::cell_t jit_sqrt(typename Policy::cell_t a, Jit<Policy> *jit) {
+    return Policy::sqrt(a, &jit -> process -> fixed);
+}
+
+
+/// Returns RAM cell address or nullptr for wrong index
+template <typename Policy>
+static typename Policy::cell_t *jit_address(typename Policy::cell_t a, typename Policy::cell_t b, Jit<Policy> *jit) {
+    long long index = Policy::to_int(a + b, &jit -> process -> fixed);
+
+    if (index < 0 || (size_t) index >= jit -> process -> ram_size) return nullptr;
+
+    return jit -> process -> ram + index;
+}
+
+
+/// Pushes value to value stack
+template <typename Policy>
+static int jit_push(typename Policy::cell_t a, Jit<Policy> *jit) {
+    return stack_push(&jit -> process -> value_stack, a);
+}
+
+
+/// Pops value from value stack to register file
+template <typename Policy>
+static int jit_pop(typename Policy::cell_t *dst, Jit<Policy> *jit) {
+    return stack_pop(&jit -> process -> value_stack, dst);
+}
+
+
+/**
+ * \brief Compiles recorded trace into native code
+ * \param jit Trace compiler with recorded trace
+ * \return Non zero value means error
+ * \note Every operation reads and writes register file, guards leave trace where recorded branch direction changes
+*/
+template <typename Policy>
+static int jit_compile(Jit<Policy> *jit) {
+    typedef typename Policy::cell_t cell_t;
+
+    if (!jit_native_cell((cell_t) 0)) return 1;
+
+    const RegOp *ops = jit -> regcode -> ops;
+
+    size_t capacity = (jit -> length + 2) * JIT_OP_SIZE;
+
+    void *memory = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (memory == MAP_FAILED) return 1;
+
+    JitBuffer buffer = {(unsigned char *) memory, 0};
+
+    // Epilogue: pop r13; pop r12; pop rbx; ret
+    const unsigned char epilogue[] = {0x41, 0x5D, 0x41, 0x5C, 0x5B, 0xC3};
+
+    // Prologue: push rbx; push r12; push r13; mov rbx, rdi; mov r12, rsi
+    const unsigned char prologue[] = {0x53, 0x41, 0x54, 0x41, 0x55, 0x48, 0x89, 0xFB, 0x49, 0x89, 0xF4};
+
+    jit_bytes(&buffer, epilogue, sizeof(epilogue));
+
+    size_t entry = buffer.size;
+
+    jit_bytes(&buffer, prologue, sizeof(prologue));
+
+    size_t body = buffer.size;
+
+    for(size_t i = 0; i < jit -> length; i++) {
+        int index = jit -> trace[i];
+        int next = (i + 1 < jit -> length) ? jit -> trace[i + 1] : jit -> head;
+        const RegOp *op = ops + index;
+
+        switch (op -> op) {
+            case REG_MOV:
+                jit_load<cell_t>(&buffer, X86_EAX, op -> a);
+                jit_store<cell_t>(&buffer, X86_EAX, op -> dst);
+                break;
+
+            case REG_ADD: case REG_SUB:
+                jit_load<cell_t>(&buffer, X86_EAX, op -> a);
+                jit_load<cell_t>(&buffer, X86_ECX, op -> b);
+                jit_eax_ecx<cell_t>(&buffer, (op -> op == REG_ADD) ? 0x01 : 0x29);
+                jit_store<cell_t>(&buffer, X86_EAX, op -> dst);
+                break;
+
+            case REG_DIV:
+                jit_load<cell_t>(&buffer, X86_ECX, op -> b);
+                jit_test<cell_t>(&buffer, X86_ECX);
+                jit_guard(&buffer, X86_NE, index);
+
+                // fall through
+            case REG_MUL:
+                jit_load<cell_t>(&buffer, X86_EDI, op -> a);
+                jit_load<cell_t>(&buffer, X86_ESI, op -> b);
+                jit_call(&buffer, (const void *)((op -> op == REG_MUL) ? &jit_mul<Policy> : &jit_div<Policy>), 2);
+                jit_store<cell_t>(&buffer, X86_EAX, op -> dst);
+                break;
+
+            case REG_SQRT:
+                jit_load<cell_t>(&buffer, X86_EDI, op -> a);
+                jit_test<cell_t>(&buffer, X86_EDI);
+                jit_guard(&buffer, X86_NS, index);
+                jit_call(&buffer, (const void *) &jit_sqrt<Policy>, 1);
+                jit_store<cell_t>(&buffer, X86_EAX, op -> dst);
+                break;
+
+            case REG_LOAD: case REG_STORE: {
+                // mov ecx, [rax] and mov [rax], ecx
+                const unsigned char load[] = {0x8B, 0x08}, store[] = {0x89, 0x08};
+
+                jit_load<cell_t>(&buffer, X86_EDI, op -> a);
+                jit_load<cell_t>(&buffer, X86_ESI, op -> b);
+                jit_call(&buffer, (const void *) &jit_address<Policy>, 2);
+
+                jit_test<long long>(&buffer, X86_EAX);
+                jit_guard(&buffer, X86_NE, index);
+
+                if (op -> op == REG_LOAD) {
+                    jit_cell_prefix<cell_t>(&buffer);
+                    jit_bytes(&buffer, load, sizeof(load));
+                    jit_store<cell_t>(&buffer, X86_ECX, op -> dst);
+                }
+                else {
+                    jit_load<cell_t>(&buffer, X86_ECX, op -> dst);
+                    jit_cell_prefix<cell_t>(&buffer);
+                    jit_bytes(&buffer, store, sizeof(store));
+                }
+
+                break;
+            }
+
+            case REG_PUSH: case REG_POP: {
+                // lea rdi, [rbx + dst * cell size]
+                const unsigned char lea_rdi[] = {0x48, 0x8D, 0xBB};
+
+                if (op -> op == REG_PUSH)
+                    jit_load<cell_t>(&buffer, X86_EDI, op -> a);
+                else {
+                    jit_bytes(&buffer, lea_rdi, sizeof(lea_rdi));
+                    jit_int(&buffer, op -> dst * (int) sizeof(cell_t));
+                }
+
+                jit_call(&buffer, (op -> op == REG_PUSH) ? (const void *) &jit_push<Policy> : (const void *) &jit_pop<Policy>, 1);
+
+                jit_test<int>(&buffer, X86_EAX);
+                jit_guard(&buffer, X86_E, index);
+                break;
+            }
+
+            case REG_JMP: break;
+
+            case REG_JB: case REG_JA: case REG_JE: case REG_JNE: case REG_JAE: case REG_JBE: {
+                if (op -> dst == index + 1) break;
+
+                const int conditions[] = {X86_L, X86_G, X86_E, X86_NE, X86_GE, X86_LE};
+                int condition = conditions[op -> op - REG_JB];
+
+                jit_load<cell_t>(&buffer, X86_EAX, op -> a);
+                jit_load<cell_t>(&buffer, X86_ECX, op -> b);
+                jit_eax_ecx<cell_t>(&buffer, 0x39);
+
+                if (next == op -> dst)
+                    jit_guard(&buffer, condition, index + 1);
+                else
+                    jit_guard(&buffer, condition ^ 1, (op -> dst > -1) ? op -> dst : index);
+
+                break;
+            }
+
+            default:
+                munmap(memory, capacity);
+                return 1;
+        }
+    }
+
+    // jmp body
+    const unsigned char jmp = 0xE9;
+
+    jit_bytes(&buffer, &jmp, 1);
+    jit_int(&buffer, (int) body - (int)(buffer.size + sizeof(int)));
+
+    if (mprotect(memory, capacity, PROT_READ | PROT_EXEC)) {
+        munmap(memory, capacity);
+        return 1;
+    }
+
+    jit -> native[jit -> head] = (typename Jit<Policy>::function_t)(void *)(buffer.code + entry);
+    jit -> memory[jit -> head] = memory;
+    jit -> sizes[jit -> head] = capacity;
+
+    return 0;
+}
+
+
+/// Frees native code of one trace
+template <typename Policy>
+static void jit_release(Jit<Policy> *jit, size_t head) {
+    munmap(jit -> memory[head], jit -> sizes[head]);
+}
+
+
+#else
+
+
+template <typename Policy>
+static int jit_compile(Jit<Policy> *jit) {
+    return 1;
+}
+
+
+template <typename Policy>
+static void jit_release(Jit<Policy> *jit, size_t head) {}
+
+
+#endif
+
+
+template <typename Policy>
+int jit_enter(Jit<Policy> *jit, int head) {
+    if (jit -> head > -1) {
+        if (head != jit -> head)
+            jit_abort(jit);
+
+        return head;
+    }
+
+    if (jit -> native[head])
+        return jit_run(jit, head);
+
+    if (jit -> hits[head] > -1 && ++jit -> hits[head] >= JIT_HOT_LOOP) {
+        jit -> head = head;
+        jit -> length = 0;
+    }
+
+    return head;
+}
+
+
+template <typename Policy>
+int jit_record(Jit<Policy> *jit, int index) {
+    if (index == jit -> head && jit -> length) {
+        if (jit_compile(jit)) {
+            jit_abort(jit);
+            return -1;
+        }
+
+        jit -> head = -1;
+        jit -> compiled++;
+
+        return jit_run(jit, index);
+    }
+
+    switch (jit -> regcode -> ops[index].op) {
+        case REG_MOV: case REG_ADD: case REG_SUB: case REG_MUL: case REG_DIV: case REG_SQRT:
+        case REG_LOAD: case REG_STORE: case REG_PUSH: case REG_POP:
+        case REG_JMP: case REG_JB: case REG_JA: case REG_JE: case REG_JNE: case REG_JAE: case REG_JBE:
+            break;
+
+        default:
+            jit_abort(jit);
+            return -1;
+    }
+
+    if (jit -> length == JIT_TRACE_SIZE) {
+        jit_abort(jit);
+        return -1;
+    }
+
+    jit -> trace[jit -> length++] = index;
+
+    return -1;
+}
+
+
+template <typename Policy>
+int jit_constructor(Jit<Policy> *jit, Process<Policy> *process, RegCode<typename Policy::cell_t> *regcode) {
+    ASSERT(jit && process && regcode, "Can't work with then null pointer!");
+
+    jit -> process = process;
+    jit -> regcode = regcode;
+
+    jit -> hits = (int *) calloc(regcode -> count, sizeof(int));
+    jit -> native = (typename Jit<Policy>::function_t *) calloc(regcode -> count, sizeof(typename Jit<Policy>::function_t));
+    jit -> memory = (void **) calloc(regcode -> count, sizeof(void *));
+    jit -> sizes = (size_t *) calloc(regcode -> count, sizeof(size_t));
+
+    ASSERT(jit -> hits && jit -> native && jit -> memory && jit -> sizes, "Can't allocate trace compiler!");
+
+    return 0;
+}
+
+
+template <typename Policy>
+void jit_destructor(Jit<Policy> *jit) {
+    if (jit -> native) {
+        for(size_t i = 0; i < jit -> regcode -> count; i++)
+            if (jit -> native[i]) jit_release(jit, i);
+    }
+
+    free(jit -> hits);
+    free(jit -> native);
+    free(jit -> memory);
+    free(jit -> sizes);
+
+    *jit = {};
+}
@@ -0,0 +1,183 @@
+/**
+ * \file
+ * \brief Fixed point arithmetic module source
+*/
+
+#include <ctype.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fixed.hpp"
+
+
+/// Maximum amount of fraction digits taken into account
+#define MAX_FRACTION 9
+
+/// Exponent that is larger than exponent of any number that fits in cell
+#define MAX_EXPONENT 1000
+
+/// Fraction scale limit for negative exponent (smaller digits are dropped)
+#define MAX_SCALE 1000000000000000000LL
+
+/// Maximum length of double in text
+#define MAX_NUMBER 64
+
+
+
+
+int fixed_constructor(Fixed *fixed, int precision) {
+    if (!fixed || precision <= 0) return 1;
+
+    fixed -> precision = precision;
+    fixed -> shift = -1;
+
+    if ((precision & (precision - 1)) == 0) {
+        fixed -> shift = 0;
+
+        while ((1 << fixed -> shift) != precision)
+            fixed -> shift++;
+    }
+
+    return 0;
+}
+
+
+int fixed_sqrt(int value, const Fixed *fixed) {
+    if (value <= 0) return 0;
+
+    unsigned long long square = (unsigned long long) value * (unsigned long long) fixed -> precision;
+    unsigned long long root = 0, bit = 1ULL << 62;
+
+    while (bit > square)
+        bit >>= 2;
+
+    while (bit) {
+        if (square >= root + bit) {
+            square -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+
+        bit >>= 2;
+    }
+
+    return (int) root;
+}
+
+
+long long fixed_sqrt64(long long value, const Fixed *fixed) {
+    if (value <= 0) return 0;
+
+    unsigned __int128 square = (unsigned __int128) value * (unsigned __int128) fixed -> precision;
+    unsigned __int128 root = 0, bit = (unsigned __int128) 1 << 126;
+
+    while (bit > square)
+        bit >>= 2;
+
+    while (bit) {
+        if (square >= root + bit) {
+            square -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+            root >>= 1;
+
+        bit >>= 2;
+    }
+
+    return (long long) root;
+}
+
+
+int fixed_parse(const char *str, const char *end, long long *value, const Fixed *fixed) {
+    int sign = 1;
+
+    if (str < end && (*str == '-' || *str == '+'))
+        sign = (*str++ == '-') ? -1 : 1;
+
+    long long integer = 0, fraction = 0, scale = 1;
+    int digits = 0;
+
+    for(; str < end && isdigit(*str); str++, digits++)
+        integer = integer * 10 + (*str - '0');
+
+    if (str < end && *str == '.') {
+        str++;
+
+        for(int count = 0; str < end && isdigit(*str); str++, count++, digits++) {
+            if (count < MAX_FRACTION) {
+                fraction = fraction * 10 + (*str - '0');
+                scale *= 10;
+            }
+        }
+    }
+
+    int exponent = 0;
+
+    if (digits && str < end && (*str == 'e' || *str == 'E')) {
+        int exponent_sign = 1;
+
+        if (++str < end && (*str == '-' || *str == '+'))
+            exponent_sign = (*str++ == '-') ? -1 : 1;
+
+        if (str == end) return 1;
+
+        for(; str < end && isdigit(*str); str++) {
+            if (exponent < MAX_EXPONENT)
+                exponent = exponent * 10 + (*str - '0');
+        }
+
+        exponent *= exponent_sign;
+    }
+
+    if (str != end || !digits) return 1;
+
+    // Exponent moves digits between integer and fraction
+    for(; exponent > 0; exponent--) {
+        long long digit = 0;
+
+        if (scale > 1) {
+            scale /= 10;
+            digit = fraction / scale;
+            fraction %= scale;
+        }
+
+        if (integer > (LLONG_MAX - digit) / 10) return 1;
+
+        integer = integer * 10 + digit;
+    }
+
+    for(; exponent < 0 && scale < MAX_SCALE; exponent++) {
+        fraction += integer % 10 * scale;
+        integer /= 10;
+        scale *= 10;
+    }
+
+    if (exponent < 0)
+        integer = fraction = 0;
+
+    *value = sign * (integer * fixed -> precision + (long long)((__int128) fraction * fixed -> precision / scale));
+
+    return 0;
+}
+
+
+int double_parse(const char *str, const char *end, double *value) {
+    char number[MAX_NUMBER] = "";
+    size_t length = (size_t)(end - str);
+
+    if (!length || length >= sizeof(number)) return 1;
+
+    // strtod() also takes spaces, hexadecimal numbers, infinity and NaN
+    for(size_t i = 0; i < length; i++)
+        if (!isdigit(str[i]) && !strchr("+-.eE", str[i])) return 1;
+
+    memcpy(number, str, length);
+
+    char *stop = nullptr;
+
+    *value = strtod(number, &stop);
+
+    return stop != number + length;
+}
@@ -0,0 +1,156 @@
+/**
+ * \file
+ * \brief Fixed point arithmetic module header
+*/
+
+
+/// Fixed point number format
+typedef struct {
+    int precision = 1000;   ///< Number of units in one
+    int shift = -1;         ///< log2(precision) if precision is power of two, -1 otherwise
+} Fixed;
+
+
+/**
+ * \brief Sets fixed point format
+ * \param [out] fixed Format to set
+ * \param [in]  precision Number of units in one (powers of two make multiplication a shift)
+ * \return Non zero value means error
+*/
+int fixed_constructor(Fixed *fixed, int precision);
+
+
+/**
+ * \brief Integer square root of fixed point number
+ * \param [in] value Non negative fixed point number
+ * \param [in] fixed Number format
+ * \return Fixed point root rounded down
+*/
+int fixed_sqrt(int value, const Fixed *fixed);
+
+
+/**
+ * \brief Integer square root of 64 bit fixed point number
+ * \param [in] value Non negative fixed point number
+ * \param [in] fixed Number format
+ * \return Fixed point root rounded down
+*/
+long long fixed_sqrt64(long long value, const Fixed *fixed);
+
+
+/**
+ * \brief Converts decimal number to fixed point without floating point operations
+ * \param [in]  str Number start
+ * \param [in]  end Number end
+ * \param [out] value Fixed point number (fraction digits beyond precision are truncated)
+ * \param [in]  fixed Number format
+ * \note Number can have exponent (1.5e3, 2E-2)
+ * \return Non zero value means invalid number
+*/
+int fixed_parse(const char *str, const char *end, long long *value, const Fixed *fixed);
+
+
+/**
+ * \brief Converts decimal number to double accepting the same syntax as fixed_parse
+ * \param [in]  str Number start
+ * \param [in]  end Number end
+ * \param [out] value Number
+ * \return Non zero value means invalid number
+*/
+int double_parse(const char *str, const char *end, double *value);
+
+
+/**
+ * \brief Divides by precision rounding towards zero
+ * \param [in] value Number of units multiplied by precision
+ * \param [in] fixed Number format
+ * \return Number of units
+*/
+inline int fixed_reduce(long long value, const Fixed *fixed) {
+    if (fixed -> shift >= 0)
+        return (int)((value + ((value >> 63) & ((1LL << fixed -> shift) - 1))) >> fixed -> shift);
+
+    return (int)(value / fixed -> precision);
+}
+
+
+/**
+ * \brief Converts fixed point number to integer rounding towards zero
+*/
+inline int fixed_to_int(int value, const Fixed *fixed) {
+    return fixed_reduce(value, fixed);
+}
+
+
+/**
+ * \brief Converts integer to fixed point number
+*/
+inline int fixed_from_int(long long value, const Fixed *fixed) {
+    return (int)((fixed -> shift >= 0) ? value << fixed -> shift : value * fixed -> precision);
+}
+
+
+/**
+ * \brief Multiplies fixed point numbers with 64 bit intermediate result
+*/
+inline int fixed_mul(int a, int b, const Fixed *fixed) {
+    return fixed_reduce((long long) a * (long long) b, fixed);
+}
+
+
+/**
+ * \brief Divides fixed point numbers with 64 bit intermediate result
+ * \warning Divisor must not be zero
+*/
+inline int fixed_div(int a, int b, const Fixed *fixed) {
+    long long dividend = (fixed -> shift >= 0) ? (long long) a << fixed -> shift : (long long) a * fixed -> precision;
+
+    return (int)(dividend / b);
+}
+
+
+
+/**
+ * \brief Divides 128 bit value by precision rounding towards zero
+*/
+inline long long fixed_reduce64(__int128 value, const Fixed *fixed) {
+    if (fixed -> shift >= 0)
+        return (long long)((value + ((value >> 127) & (((__int128) 1 << fixed -> shift) - 1))) >> fixed -> shift);
+
+    return (long long)(value / fixed -> precision);
+}
+
+
+/**
+ * \brief Converts 64 bit fixed point number to integer rounding towards zero
+*/
+inline long long fixed_to_int64(long long value, const Fixed *fixed) {
+    return fixed_reduce64(value, fixed);
+}
+
+
+/**
+ * \brief Converts integer to 64 bit fixed point number
+*/
+inline long long fixed_from_int64(long long value, const Fixed *fixed) {
+    return (fixed -> shift >= 0) ? value << fixed -> shift : value * fixed -> precision;
+}
+
+
+/**
+ * \brief Multiplies 64 bit fixed point numbers with 128 bit intermediate result
+*/
+inline long long fixed_mul64(long long a, long long b, const Fixed *fixed) {
+    return fixed_reduce64((__int128) a * (__int128) b, fixed);
+}
+
+
+/**
+ * \brief Divides 64 bit fixed point numbers with 128 bit intermediate result
+ * \warning Divisor must not be zero
+*/
+inline long long fixed_div64(long long a, long long b, const Fixed *fixed) {
+    __int128 dividend = (fixed -> shift >= 0) ? (__int128) a << fixed -> shift : (__int128) a * fixed -> precision;
+
+    return (long long)(dividend / b);
+}
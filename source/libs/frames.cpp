@@ -0,0 +1,178 @@
+/**
+ * \file
+ * \brief Frame stream module source
+*/
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <io.h>
+#elif __linux__
+    #include <unistd.h>
+#else
+    #error "Your system case is not defined!"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include "frames.hpp"
+
+
+/// Maximum PPM header size
+#define PPM_HEADER_SIZE 32
+
+
+/**
+ * \brief Returns monotonic time
+ * \return Time in nanoseconds
+*/
+static long long get_time();
+
+
+/**
+ * \brief Sets file blocking mode
+ * \param [in] file File descriptor
+ * \param [in] block Non zero value means blocking mode
+*/
+static void set_blocking(int file, int block);
+
+
+/**
+ * \brief Writes as much of pending frame as consumer accepts
+ * \param [in] frames Stream to write in
+ * \return Non zero value means error
+*/
+static int write_pending(FrameStream *frames);
+
+
+
+
+int frames_constructor(FrameStream *frames, int file, unsigned int width, unsigned int height, int format, unsigned int rate) {
+    if (!frames || file < 0 || !width || !height) return 1;
+
+    size_t cells = (size_t) width * height;
+
+    frames -> buffer = (unsigned char *) calloc(PPM_HEADER_SIZE + cells * sizeof(int), sizeof(unsigned char));
+
+    if (!frames -> buffer) return 1;
+
+    frames -> file = file;
+    frames -> format = format;
+    frames -> width = width;
+    frames -> height = height;
+    frames -> interval = (rate) ? 1000000000LL / rate : 0;
+    frames -> last = 0;
+    frames -> pending = 0;
+    frames -> shown = frames -> written = frames -> dropped = 0;
+
+    set_blocking(file, 0);
+
+    return 0;
+}
+
+
+int frames_write(FrameStream *frames, const int *cells) {
+    if (!frames || !frames -> buffer || !cells) return 1;
+
+    frames -> shown++;
+
+    if (frames -> interval) {
+        long long now = get_time();
+
+        if (frames -> written && now - frames -> last < frames -> interval) {
+            frames -> dropped++;
+            return 0;
+        }
+
+        frames -> last = now;
+    }
+
+    if (frames -> pending && write_pending(frames)) {
+        frames -> dropped++;
+        return errno != EAGAIN;
+    }
+
+    size_t cells_count = (size_t) frames -> width * frames -> height;
+
+    if (frames -> format == FRAMES_RAW) {
+        memcpy(frames -> buffer, cells, cells_count * sizeof(int));
+
+        frames -> size = cells_count * sizeof(int);
+    }
+    else {
+        int header = snprintf((char *) frames -> buffer, PPM_HEADER_SIZE, "P6\n%u %u\n255\n", frames -> width, frames -> height);
+
+        unsigned char *pixel = frames -> buffer + header;
+
+        for(size_t i = 0; i < cells_count; i++) {
+            *pixel++ = (unsigned char)(cells[i] >> 16);
+            *pixel++ = (unsigned char)(cells[i] >> 8);
+            *pixel++ = (unsigned char)(cells[i]);
+        }
+
+        frames -> size = (size_t)(pixel - frames -> buffer);
+    }
+
+    frames -> pending = frames -> size;
+    frames -> written++;
+
+    if (write_pending(frames))
+        return errno != EAGAIN;
+
+    return 0;
+}
+
+
+int frames_destructor(FrameStream *frames) {
+    if (!frames) return 1;
+
+    set_blocking(frames -> file, 1);
+
+    int error = write_pending(frames);
+
+    free(frames -> buffer);
+    frames -> buffer = nullptr;
+
+    frames -> size = frames -> pending = 0;
+
+    return error;
+}
+
+
+static int write_pending(FrameStream *frames) {
+    while (frames -> pending) {
+        ssize_t bytes = write(frames -> file, frames -> buffer + frames -> size - frames -> pending, frames -> pending);
+
+        if (bytes <= 0) {
+            if (bytes < 0 && errno == EINTR) continue;
+
+            return 1;
+        }
+
+        frames -> pending -= (size_t) bytes;
+    }
+
+    return 0;
+}
+
+
+static long long get_time() {
+    struct timespec time = {};
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (long long) time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+
+static void set_blocking(int file, int block) {
+#ifdef O_NONBLOCK
+    int flags = fcntl(file, F_GETFL);
+
+    if (flags == -1) return;
+
+    fcntl(file, F_SETFL, (block) ? flags & ~O_NONBLOCK : flags | O_NONBLOCK);
+#endif
+}
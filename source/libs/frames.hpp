@@ -0,0 +1,63 @@
+/**
+ * \file
+ * \brief Frame stream module header
+*/
+
+
+/// Frame formats
+typedef enum {
+    FRAMES_PPM = 0, ///< Binary PPM (P6), cell low 24 bits are 0xRRGGBB
+    FRAMES_RAW = 1, ///< Cells as they are in memory
+} FRAMES_FORMAT;
+
+
+/// Stream of images written to file or pipe
+typedef struct {
+    int file = -1;                      ///< Output file descriptor (non blocking if possible)
+    int format = FRAMES_PPM;            ///< One of FRAMES_FORMAT
+
+    unsigned int width = 0;             ///< Frame width in cells
+    unsigned int height = 0;            ///< Frame height in cells
+
+    unsigned char *buffer = nullptr;    ///< Encoded frame
+    size_t size = 0;                    ///< Encoded frame size
+    size_t pending = 0;                 ///< Bytes of previous frame that are still not written
+
+    long long interval = 0;             ///< Minimal time between frames in nanoseconds
+    long long last = 0;                 ///< Time of last accepted frame
+
+    size_t shown = 0;                   ///< Frames requested by program
+    size_t written = 0;                 ///< Frames given to consumer
+    size_t dropped = 0;                 ///< Frames skipped because of rate limit or slow consumer
+} FrameStream;
+
+
+/**
+ * \brief Allocates frame buffer and switches file to non blocking mode
+ * \param [out] frames Stream to construct
+ * \param [in]  file Output file descriptor
+ * \param [in]  width Frame width in cells
+ * \param [in]  height Frame height in cells
+ * \param [in]  format One of FRAMES_FORMAT
+ * \param [in]  rate Maximum frames per second (0 means unlimited)
+ * \return Non zero value means error
+*/
+int frames_constructor(FrameStream *frames, int file, unsigned int width, unsigned int height, int format, unsigned int rate);
+
+
+/**
+ * \brief Encodes and writes frame
+ * \param [in] frames Stream to write in
+ * \param [in] cells Array of width * height cells
+ * \note Frame is dropped if it comes too early or consumer hasn't read previous one yet
+ * \return Non zero value means error
+*/
+int frames_write(FrameStream *frames, const int *cells);
+
+
+/**
+ * \brief Writes the rest of pending frame and frees buffer
+ * \param [in] frames Stream to destruct
+ * \return Non zero value means error
+*/
+int frames_destructor(FrameStream *frames);
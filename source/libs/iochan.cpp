@@ -0,0 +1,356 @@
+/**
+ * \file
+ * \brief Input/output channels module source
+*/
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <io.h>
+#elif __linux__
+    #include <unistd.h>
+    #include <poll.h>
+    #include <sys/mman.h>
+#else
+    #error "Your system case is not defined!"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/stat.h>
+#include "fixed.hpp"
+#include "iochan.hpp"
+
+
+/**
+ * \brief Moves unread data to the buffer start and reads more
+ * \param [in] channel Channel to fill
+ * \return Non zero value if something was read
+*/
+static int io_fill(IoChannel *channel);
+
+
+/**
+ * \brief Finds next space separated token and skips it
+ * \param [in]  channel Channel to read from
+ * \param [out] str Token start
+ * \param [out] end Token end
+ * \return Non zero value means end of file
+*/
+static int io_read_token(IoChannel *channel, const char **str, const char **end);
+
+
+/**
+ * \brief Reads numbers of any cell type
+ * \param [in]  channel Channel to read from
+ * \param [out] values Array for numbers
+ * \param [in]  count Maximum amount of numbers
+ * \param [in]  fixed Fixed point format for text mode
+ * \return Amount of numbers actually read
+*/
+template <typename cell_t>
+static size_t io_read_cells(IoChannel *channel, cell_t *values, size_t count, const Fixed *fixed);
+
+
+/**
+ * \brief Writes numbers of any cell type
+ * \param [in] channel Channel to write in
+ * \param [in] values Array of numbers
+ * \param [in] count Amount of numbers
+ * \param [in] fixed Fixed point format for text mode
+ * \return Amount of numbers actually written
+*/
+template <typename cell_t>
+static size_t io_write_cells(IoChannel *channel, const cell_t *values, size_t count, const Fixed *fixed);
+
+
+/// Parses 32 bit fixed point number
+static int parse_cell(const char *str, const char *end, int *value, const Fixed *fixed) {
+    long long number = 0;
+    int error = fixed_parse(str, end, &number, fixed);
+
+    *value = (int) number;
+
+    return error;
+}
+
+/// Parses 64 bit fixed point number
+static int parse_cell(const char *str, const char *end, long long *value, const Fixed *fixed) {
+    return fixed_parse(str, end, value, fixed);
+}
+
+/// Parses double
+static int parse_cell(const char *str, const char *end, double *value, const Fixed *) {
+    return double_parse(str, end, value);
+}
+
+/// Prints 32 bit fixed point number
+static int print_cell(FILE *stream, int value, const Fixed *fixed) {
+    return fprintf(stream, "%g\n", (float) value / (float) fixed -> precision);
+}
+
+/// Prints 64 bit fixed point number
+static int print_cell(FILE *stream, long long value, const Fixed *fixed) {
+    return fprintf(stream, "%.15g\n", (double) value / (double) fixed -> precision);
+}
+
+/// Prints double
+static int print_cell(FILE *stream, double value, const Fixed *) {
+    return fprintf(stream, "%.15g\n", value);
+}
+
+
+
+
+int io_open_input(IoChannel *channel, int file, int mode) {
+    if (!channel || file < 0) return 1;
+
+    channel -> in_file = file;
+    channel -> in_mode = mode;
+    channel -> pos = channel -> size = 0;
+    channel -> eof = 0;
+
+#ifdef MAP_FAILED
+    struct stat info = {};
+
+    if (!fstat(file, &info) && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void *data = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (data != MAP_FAILED) {
+            channel -> data = (char *) data;
+            channel -> size = (size_t) info.st_size;
+            channel -> eof = 1;
+
+            return 0;
+        }
+    }
+#endif
+
+    channel -> buffer = (char *) calloc(IO_BUFFER_SIZE, sizeof(char));
+
+    if (!channel -> buffer) return 1;
+
+    channel -> data = channel -> buffer;
+
+    return 0;
+}
+
+
+int io_open_output(IoChannel *channel, int file, int mode) {
+    if (!channel || file < 0) return 1;
+
+    if (file == fileno(stdout))
+        channel -> out = stdout;
+    else {
+        channel -> out = fdopen(file, (mode == IO_BINARY) ? "wb" : "w");
+
+        if (!channel -> out) return 1;
+
+        setvbuf(channel -> out, nullptr, _IOFBF, IO_BUFFER_SIZE);
+    }
+
+    channel -> out_mode = mode;
+
+    return 0;
+}
+
+
+size_t io_read(IoChannel *channel, int *values, size_t count, const Fixed *fixed) {
+    return io_read_cells(channel, values, count, fixed);
+}
+
+
+size_t io_read(IoChannel *channel, long long *values, size_t count, const Fixed *fixed) {
+    return io_read_cells(channel, values, count, fixed);
+}
+
+
+size_t io_read(IoChannel *channel, double *values, size_t count, const Fixed *fixed) {
+    return io_read_cells(channel, values, count, fixed);
+}
+
+
+size_t io_write(IoChannel *channel, const int *values, size_t count, const Fixed *fixed) {
+    return io_write_cells(channel, values, count, fixed);
+}
+
+
+size_t io_write(IoChannel *channel, const long long *values, size_t count, const Fixed *fixed) {
+    return io_write_cells(channel, values, count, fixed);
+}
+
+
+size_t io_write(IoChannel *channel, const double *values, size_t count, const Fixed *fixed) {
+    return io_write_cells(channel, values, count, fixed);
+}
+
+
+int io_close(IoChannel *channel) {
+    if (!channel) return 1;
+
+    int error = 0;
+
+    if (channel -> out) {
+        if (channel -> out == stdout)
+            error |= fflush(stdout);
+        else
+            error |= fclose(channel -> out);
+
+        channel -> out = nullptr;
+    }
+
+    if (channel -> in_file != -1) {
+#ifdef MAP_FAILED
+        if (!channel -> buffer && channel -> data)
+            munmap(channel -> data, channel -> size);
+#endif
+
+        free(channel -> buffer);
+        channel -> buffer = nullptr;
+        channel -> data = nullptr;
+
+        if (channel -> in_file != fileno(stdin))
+            close(channel -> in_file);
+
+        channel -> in_file = -1;
+    }
+
+    return error;
+}
+
+
+int io_end(IoChannel *channel) {
+    if (!channel || channel -> in_file == -1) return 1;
+
+    for(;;) {
+        if (channel -> in_mode == IO_TEXT) {
+            while (channel -> pos < channel -> size && isspace(channel -> data[channel -> pos]))
+                channel -> pos++;
+        }
+
+        if (channel -> pos < channel -> size) return 0;
+
+        if (!io_fill(channel)) return 1;
+    }
+}
+
+
+int io_ready(const IoChannel *channel) {
+    if (!channel || channel -> in_file == -1 || channel -> eof || !channel -> buffer) return 1;
+
+    if (channel -> pos < channel -> size) return 1;
+
+#ifdef POLLIN
+    struct pollfd file = {channel -> in_file, POLLIN, 0};
+
+    return poll(&file, 1, 0) != 0;
+#else
+    return 1;
+#endif
+}
+
+
+static int io_fill(IoChannel *channel) {
+    if (channel -> eof) return 0;
+
+    size_t left = channel -> size - channel -> pos;
+
+    memmove(channel -> buffer, channel -> buffer + channel -> pos, left);
+
+    channel -> size = left;
+    channel -> pos = 0;
+
+    ssize_t bytes = read(channel -> in_file, channel -> buffer + left, IO_BUFFER_SIZE - left);
+
+    if (bytes <= 0) {
+        channel -> eof = 1;
+        return 0;
+    }
+
+    channel -> size += (size_t) bytes;
+
+    return 1;
+}
+
+
+static int io_read_token(IoChannel *channel, const char **str, const char **end) {
+    for(;;) {
+        while (channel -> pos < channel -> size && isspace(channel -> data[channel -> pos]))
+            channel -> pos++;
+
+        if (channel -> pos < channel -> size) break;
+
+        if (!io_fill(channel)) return 1;
+    }
+
+    size_t length = 0;
+
+    for(;;) {
+        while (channel -> pos + length < channel -> size && !isspace(channel -> data[channel -> pos + length]))
+            length++;
+
+        if (channel -> pos + length < channel -> size || channel -> eof) break;
+
+        // Number is longer than the whole buffer
+        if (channel -> pos == 0 && channel -> size == IO_BUFFER_SIZE) break;
+
+        if (!io_fill(channel)) break;
+    }
+
+    *str = channel -> data + channel -> pos;
+    *end = *str + length;
+
+    channel -> pos += length;
+
+    return 0;
+}
+
+
+template <typename cell_t>
+static size_t io_read_cells(IoChannel *channel, cell_t *values, size_t count, const Fixed *fixed) {
+    if (!channel || !values || channel -> in_file == -1) return 0;
+
+    size_t done = 0;
+
+    if (channel -> in_mode == IO_TEXT) {
+        const char *str = nullptr, *end = nullptr;
+
+        while (done < count && !io_read_token(channel, &str, &end) && !parse_cell(str, end, values + done, fixed))
+            done++;
+
+        return done;
+    }
+
+    while (done < count) {
+        size_t available = (channel -> size - channel -> pos) / sizeof(cell_t);
+
+        if (!available) {
+            if (!io_fill(channel)) break;
+            continue;
+        }
+
+        if (available > count - done)
+            available = count - done;
+
+        memcpy(values + done, channel -> data + channel -> pos, available * sizeof(cell_t));
+
+        channel -> pos += available * sizeof(cell_t);
+        done += available;
+    }
+
+    return done;
+}
+
+
+template <typename cell_t>
+static size_t io_write_cells(IoChannel *channel, const cell_t *values, size_t count, const Fixed *fixed) {
+    if (!channel || !values || !channel -> out) return 0;
+
+    if (channel -> out_mode == IO_BINARY)
+        return fwrite(values, sizeof(cell_t), count, channel -> out);
+
+    for(size_t i = 0; i < count; i++)
+        if (print_cell(channel -> out, values[i], fixed) < 0) return i;
+
+    return count;
+}
@@ -0,0 +1,106 @@
+/**
+ * \file
+ * \brief Input/output channels module header
+*/
+
+
+/// Number of channels
+#define IO_CHANNELS 8
+
+/// Buffer size for unmapped input and file output
+#define IO_BUFFER_SIZE (1 << 20)
+
+
+/// Channel data format
+typedef enum {
+    IO_TEXT   = 0, ///< Decimal numbers separated by spaces
+    IO_BINARY = 1, ///< Raw cells as they are in memory
+} IO_MODE;
+
+
+/// Input and output bound to files
+typedef struct {
+    int in_file = -1;               ///< Input file descriptor (-1 if input is not bound)
+    int in_mode = IO_TEXT;          ///< Input format
+    char *data = nullptr;           ///< Mapped file or buffer
+    char *buffer = nullptr;         ///< Buffer if file can't be mapped
+    size_t size = 0;                ///< Available bytes in data
+    size_t pos = 0;                 ///< Read position in data
+    int eof = 0;                    ///< Nothing more can be read to buffer
+
+    FILE *out = nullptr;            ///< Output stream (nullptr if output is not bound)
+    int out_mode = IO_TEXT;         ///< Output format
+} IoChannel;
+
+
+/**
+ * \brief Binds channel input to file
+ * \param [out] channel Channel to bind
+ * \param [in]  file Input file descriptor
+ * \param [in]  mode One of IO_MODE
+ * \note Regular files are mapped to memory, other files are read by large blocks
+ * \return Non zero value means error
+*/
+int io_open_input(IoChannel *channel, int file, int mode);
+
+
+/**
+ * \brief Binds channel output to file
+ * \param [out] channel Channel to bind
+ * \param [in]  file Output file descriptor
+ * \param [in]  mode One of IO_MODE
+ * \return Non zero value means error
+*/
+int io_open_output(IoChannel *channel, int file, int mode);
+
+
+/**
+ * \brief Reads numbers of the cell type
+ * \param [in]  channel Channel to read from
+ * \param [out] values Array for numbers
+ * \param [in]  count Maximum amount of numbers
+ * \param [in]  fixed Fixed point format for text mode (ignored for double)
+ * \return Amount of numbers actually read (less than count on end of file or invalid number)
+*/
+size_t io_read(IoChannel *channel, int *values, size_t count, const Fixed *fixed);
+size_t io_read(IoChannel *channel, long long *values, size_t count, const Fixed *fixed);    ///< 64 bit fixed point version
+size_t io_read(IoChannel *channel, double *values, size_t count, const Fixed *fixed);       ///< Double version
+
+
+/**
+ * \brief Checks that input has no more numbers (waits for input like io_read())
+ * \param [in] channel Channel to check
+ * \return Non zero value if input ended (only spaces are left in text mode)
+*/
+int io_end(IoChannel *channel);
+
+
+/**
+ * \brief Checks that io_read() will not wait for input
+ * \param [in] channel Channel to check
+ * \note Systems without poll() always report ready input
+ * \return Non zero value if data is buffered, input is mapped or ended, or file has data to read
+*/
+int io_ready(const IoChannel *channel);
+
+
+/**
+ * \brief Writes numbers of the cell type
+ * \param [in] channel Channel to write in
+ * \param [in] values Array of numbers
+ * \param [in] count Amount of numbers
+ * \param [in] fixed Fixed point format for text mode (ignored for double)
+ * \return Amount of numbers actually written
+*/
+size_t io_write(IoChannel *channel, const int *values, size_t count, const Fixed *fixed);
+size_t io_write(IoChannel *channel, const long long *values, size_t count, const Fixed *fixed);  ///< 64 bit fixed point version
+size_t io_write(IoChannel *channel, const double *values, size_t count, const Fixed *fixed);     ///< Double version
+
+
+/**
+ * \brief Flushes output and unbinds channel
+ * \param [in] channel Channel to close
+ * \note Standard streams are flushed but not closed
+ * \return Non zero value means error
+*/
+int io_close(IoChannel *channel);
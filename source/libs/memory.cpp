@@ -0,0 +1,159 @@
+/**
+ * \file
+ * \brief Virtual memory module source
+*/
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+#elif __linux__
+    #include <unistd.h>
+    #include <sys/mman.h>
+#else
+    #error "Your system case is not defined!"
+#endif
+
+#include <stdlib.h>
+#include <ctype.h>
+#include "memory.hpp"
+
+
+
+
+void *memory_map(size_t size) {
+    if (!size) return nullptr;
+
+#if defined(_WIN32) || defined(_WIN64)
+    return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void *ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    return (ptr == MAP_FAILED) ? nullptr : ptr;
+#endif
+}
+
+
+int memory_unmap(void *ptr, size_t size) {
+    if (!ptr) return 1;
+
+#if defined(_WIN32) || defined(_WIN64)
+    return !VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+    return munmap(ptr, size);
+#endif
+}
+
+
+int memory_reset(void *ptr, size_t size) {
+    if (!ptr) return 1;
+
+    size_t page = memory_page_size();
+    size_t gap = (size_t) ptr % page;
+    char *start = (char *) ptr - gap;
+
+#if defined(_WIN32) || defined(_WIN64)
+    // Decommitted pages are zero filled on the next commit
+    return !VirtualFree(start, gap + size, MEM_DECOMMIT) || !VirtualAlloc(start, gap + size, MEM_COMMIT, PAGE_READWRITE);
+#else
+    // Private anonymous pages are zero filled on the next access
+    return madvise(start, gap + size, MADV_DONTNEED);
+#endif
+}
+
+
+int memory_huge(void *ptr, size_t size) {
+    if (!ptr) return 1;
+
+#if defined(_WIN32) || defined(_WIN64)
+    // Large pages need privilege and have to be committed at once
+    return 1;
+#else
+    size_t gap = (size_t) ptr % memory_page_size();
+
+    return madvise((char *) ptr - gap, gap + size, MADV_HUGEPAGE);
+#endif
+}
+
+
+size_t memory_page_size() {
+#if defined(_WIN32) || defined(_WIN64)
+    SYSTEM_INFO info = {};
+    GetSystemInfo(&info);
+
+    return info.dwPageSize;
+#else
+    return (size_t) sysconf(_SC_PAGESIZE);
+#endif
+}
+
+
+/**
+ * \brief Returns gap between guard page and memory given by memory_map_guarded()
+ * \param [in] size Size of accessible part in bytes
+ * \param [in] page Page size
+*/
+static size_t memory_guard_gap(size_t size, size_t page) {
+    return (page - size % page) % page;
+}
+
+
+void *memory_map_guarded(size_t size, size_t reserve) {
+    if (!size || reserve < size) return nullptr;
+
+    size_t page = memory_page_size();
+    size_t gap = memory_guard_gap(size, page);
+
+    // Accessible part ends at page boundary, so the first cell after it faults
+#if defined(_WIN32) || defined(_WIN64)
+    char *range = (char *) VirtualAlloc(nullptr, page + gap + reserve, MEM_RESERVE, PAGE_NOACCESS);
+
+    if (!range) return nullptr;
+
+    if (!VirtualAlloc(range + page, gap + size, MEM_COMMIT, PAGE_READWRITE)) {
+        VirtualFree(range, 0, MEM_RELEASE);
+        return nullptr;
+    }
+#else
+    char *range = (char *) mmap(nullptr, page + gap + reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    if (range == MAP_FAILED) return nullptr;
+
+    if (mprotect(range + page, gap + size, PROT_READ | PROT_WRITE)) {
+        munmap(range, page + gap + reserve);
+        return nullptr;
+    }
+#endif
+
+    return range + page + gap;
+}
+
+
+int memory_unmap_guarded(void *ptr, size_t size, size_t reserve) {
+    if (!ptr) return 1;
+
+    size_t page = memory_page_size();
+    size_t gap = memory_guard_gap(size, page);
+
+#if defined(_WIN32) || defined(_WIN64)
+    return !VirtualFree((char *) ptr - gap - page, 0, MEM_RELEASE);
+#else
+    return munmap((char *) ptr - gap - page, page + gap + reserve);
+#endif
+}
+
+
+size_t memory_parse_size(const char *str) {
+    if (!str || !isdigit(*str)) return 0;
+
+    char *end = nullptr;
+    size_t size = strtoull(str, &end, 10);
+
+    switch (toupper(*end)) {
+        case 'G': size <<= 10; [[fallthrough]];
+        case 'M': size <<= 10; [[fallthrough]];
+        case 'K': size <<= 10; end++; break;
+        case '\0': break;
+        default: return 0;
+    }
+
+    return (*end == '\0') ? size : 0;
+}
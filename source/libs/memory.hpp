@@ -0,0 +1,77 @@
+/**
+ * \file
+ * \brief Virtual memory module header
+*/
+
+
+/**
+ * \brief Reserves zero filled memory which is committed page by page on first access
+ * \param [in] size Size in bytes
+ * \note Untouched pages don't consume physical memory
+ * \return Pointer to memory or nullptr on error
+*/
+void *memory_map(size_t size);
+
+
+/**
+ * \brief Releases memory reserved by memory_map()
+ * \param [in] ptr Pointer returned by memory_map()
+ * \param [in] size Size given to memory_map()
+ * \return Non zero value means error
+*/
+int memory_unmap(void *ptr, size_t size);
+
+
+/**
+ * \brief Reserves address range without access and makes its beginning memory like memory_map() does
+ * \param [in] size Size of accessible part in bytes
+ * \param [in] reserve Size of the whole range in bytes (not less than size)
+ * \note Accessible part ends at page boundary and range is preceded by one more page without access,
+ * so access right before and right after memory faults
+ * \return Pointer to accessible part (not aligned to page) or nullptr on error
+*/
+void *memory_map_guarded(size_t size, size_t reserve);
+
+
+/**
+ * \brief Releases memory reserved by memory_map_guarded()
+ * \param [in] ptr Pointer returned by memory_map_guarded()
+ * \param [in] size Size given to memory_map_guarded()
+ * \param [in] reserve Reserve given to memory_map_guarded()
+ * \return Non zero value means error
+*/
+int memory_unmap_guarded(void *ptr, size_t size, size_t reserve);
+
+
+/**
+ * \brief Zeroes memory reserved by memory_map() or memory_map_guarded() and returns its pages to system
+ * \param [in] ptr Range start
+ * \param [in] size Range size in bytes
+ * \note Whole pages that contain range are zeroed, time doesn't depend on the number of pages
+ * \return Non zero value means error
+*/
+int memory_reset(void *ptr, size_t size);
+
+
+/**
+ * \brief Asks system to back memory with huge pages
+ * \param [in] ptr Range start
+ * \param [in] size Range size in bytes
+ * \note It is only a hint, memory works as before if system ignores it
+ * \return Non zero value means that system doesn't support huge pages
+*/
+int memory_huge(void *ptr, size_t size);
+
+
+/**
+ * \brief Returns size of memory page
+*/
+size_t memory_page_size();
+
+
+/**
+ * \brief Converts string like "64", "16K", "256M" or "2G" to number
+ * \param [in] str String to convert
+ * \return Number or 0 if string is invalid
+*/
+size_t memory_parse_size(const char *str);
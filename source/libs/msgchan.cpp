@@ -0,0 +1,179 @@
+/**
+ * \file
+ * \brief Message channels module source
+ * \note Every slot has sequence number: slot at position pos is free for sender when sequence == pos
+ * and is ready for receiver when sequence == pos + 1, receiver makes it free for the next lap
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "msgchan.hpp"
+
+
+/**
+ * \brief Takes position of the next free slot
+ * \param [in] channel Channel to send to
+ * \return Slot or nullptr if channel is full
+*/
+static MessageSlot *msg_take_free(MessageChannel *channel);
+
+
+/**
+ * \brief Takes position of the next ready slot
+ * \param [in] channel Channel to receive from
+ * \return Slot or nullptr if channel is empty
+*/
+static MessageSlot *msg_take_ready(MessageChannel *channel);
+
+
+
+
+int msg_constructor(MessageChannel *channel, size_t capacity) {
+    if (!channel || !capacity) return 1;
+
+    *channel = {};
+
+    // Sender can't tell free slot from full one in ring of one slot
+    size_t size = 2;
+
+    while (size < capacity)
+        size *= 2;
+
+    channel -> slots = (MessageSlot *) calloc(size, sizeof(MessageSlot));
+
+    if (!channel -> slots) return 1;
+
+    for(size_t i = 0; i < size; i++)
+        channel -> slots[i].sequence = i;
+
+    channel -> mask = size - 1;
+
+    return 0;
+}
+
+
+void msg_destructor(MessageChannel *channel) {
+    if (!channel) return;
+
+    free(channel -> slots);
+
+    *channel = {};
+}
+
+
+void msg_close(MessageChannel *channel) {
+    __atomic_store_n(&channel -> closed, 1, __ATOMIC_RELEASE);
+}
+
+
+int msg_closed(MessageChannel *channel) {
+    return __atomic_load_n(&channel -> closed, __ATOMIC_ACQUIRE);
+}
+
+
+static MessageSlot *msg_take_free(MessageChannel *channel) {
+    size_t pos = __atomic_load_n(&channel -> tail, __ATOMIC_RELAXED);
+
+    for(;;) {
+        MessageSlot *slot = channel -> slots + (pos & channel -> mask);
+
+        size_t sequence = __atomic_load_n(&slot -> sequence, __ATOMIC_ACQUIRE);
+        long long diff = (long long) sequence - (long long) pos;
+
+        if (!diff) {
+            if (__atomic_compare_exchange_n(&channel -> tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                return slot;
+        }
+        else if (diff < 0)
+            return nullptr;
+        else
+            pos = __atomic_load_n(&channel -> tail, __ATOMIC_RELAXED);
+    }
+}
+
+
+static MessageSlot *msg_take_ready(MessageChannel *channel) {
+    size_t pos = __atomic_load_n(&channel -> head, __ATOMIC_RELAXED);
+
+    for(;;) {
+        MessageSlot *slot = channel -> slots + (pos & channel -> mask);
+
+        size_t sequence = __atomic_load_n(&slot -> sequence, __ATOMIC_ACQUIRE);
+        long long diff = (long long) sequence - (long long)(pos + 1);
+
+        if (!diff) {
+            if (__atomic_compare_exchange_n(&channel -> head, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                return slot;
+        }
+        else if (diff < 0)
+            return nullptr;
+        else
+            pos = __atomic_load_n(&channel -> head, __ATOMIC_RELAXED);
+    }
+}
+
+
+template <typename cell_t>
+static size_t msg_send_cells(MessageChannel *channel, const cell_t *values, size_t count) {
+    if (!channel || !channel -> slots || !values) return 0;
+
+    size_t done = 0;
+
+    for(MessageSlot *slot = nullptr; done < count && (slot = msg_take_free(channel)); done++) {
+        size_t sequence = slot -> sequence;
+
+        memcpy(&slot -> value, values + done, sizeof(cell_t));
+
+        __atomic_store_n(&slot -> sequence, sequence + 1, __ATOMIC_RELEASE);
+    }
+
+    return done;
+}
+
+
+template <typename cell_t>
+static size_t msg_recv_cells(MessageChannel *channel, cell_t *values, size_t count) {
+    if (!channel || !channel -> slots || !values) return 0;
+
+    size_t done = 0;
+
+    for(MessageSlot *slot = nullptr; done < count && (slot = msg_take_ready(channel)); done++) {
+        size_t sequence = slot -> sequence;
+
+        memcpy(values + done, &slot -> value, sizeof(cell_t));
+
+        __atomic_store_n(&slot -> sequence, sequence + channel -> mask, __ATOMIC_RELEASE);
+    }
+
+    return done;
+}
+
+
+size_t msg_send(MessageChannel *channel, const int *values, size_t count) {
+    return msg_send_cells(channel, values, count);
+}
+
+
+size_t msg_send(MessageChannel *channel, const long long *values, size_t count) {
+    return msg_send_cells(channel, values, count);
+}
+
+
+size_t msg_send(MessageChannel *channel, const double *values, size_t count) {
+    return msg_send_cells(channel, values, count);
+}
+
+
+size_t msg_recv(MessageChannel *channel, int *values, size_t count) {
+    return msg_recv_cells(channel, values, count);
+}
+
+
+size_t msg_recv(MessageChannel *channel, long long *values, size_t count) {
+    return msg_recv_cells(channel, values, count);
+}
+
+
+size_t msg_recv(MessageChannel *channel, double *values, size_t count) {
+    return msg_recv_cells(channel, values, count);
+}
@@ -0,0 +1,88 @@
+/**
+ * \file
+ * \brief Message channels module header
+*/
+
+
+/// Number of message channels
+#define MSG_CHANNELS 16
+
+/// Default channel capacity in cells
+#define MSG_CAPACITY 1024
+
+/// Cache line size used to separate read and write positions
+#define MSG_CACHE_LINE 64
+
+
+/// Cell in channel ring
+typedef struct {
+    size_t sequence = 0;            ///< Position this slot is ready for (see msg_send() and msg_recv())
+    long long value = 0;            ///< Cell bits
+} MessageSlot;
+
+
+/// Bounded lock-free queue of cells, any number of processes may send and receive
+typedef struct {
+    MessageSlot *slots = nullptr;               ///< Ring of slots
+    size_t mask = 0;                            ///< Capacity - 1 (capacity is power of two)
+    char head_pad[MSG_CACHE_LINE] = "";         ///< Keeps positions on different cache lines
+    size_t head = 0;                            ///< Next position to receive
+    char tail_pad[MSG_CACHE_LINE] = "";         ///< Keeps positions on different cache lines
+    size_t tail = 0;                            ///< Next position to send
+    int closed = 0;                             ///< Channel is closed because some process failed
+} MessageChannel;
+
+
+/**
+ * \brief Creates channel
+ * \param [out] channel Channel to create
+ * \param [in]  capacity Minimal capacity in cells (rounded up to power of two, at least two)
+ * \return Non zero value means error
+*/
+int msg_constructor(MessageChannel *channel, size_t capacity);
+
+
+/**
+ * \brief Frees channel
+ * \param [in] channel Channel to free
+*/
+void msg_destructor(MessageChannel *channel);
+
+
+/**
+ * \brief Closes channel, so processes waiting for it can stop
+ * \param [in] channel Channel to close
+*/
+void msg_close(MessageChannel *channel);
+
+
+/**
+ * \brief Checks if channel is closed
+ * \param [in] channel Channel to check
+*/
+int msg_closed(MessageChannel *channel);
+
+
+/**
+ * \brief Sends cells without waiting
+ * \param [in] channel Channel to send to
+ * \param [in] values Array of cells
+ * \param [in] count Amount of cells
+ * \note Cells of one call can interleave with cells sent by other threads
+ * \return Amount of cells actually sent (less than count if channel is full)
+*/
+size_t msg_send(MessageChannel *channel, const int *values, size_t count);
+size_t msg_send(MessageChannel *channel, const long long *values, size_t count);   ///< 64 bit fixed point version
+size_t msg_send(MessageChannel *channel, const double *values, size_t count);      ///< Double version
+
+
+/**
+ * \brief Receives cells without waiting
+ * \param [in]  channel Channel to receive from
+ * \param [out] values Array for cells
+ * \param [in]  count Maximum amount of cells
+ * \return Amount of cells actually received (less than count if channel is empty)
+*/
+size_t msg_recv(MessageChannel *channel, int *values, size_t count);
+size_t msg_recv(MessageChannel *channel, long long *values, size_t count);     ///< 64 bit fixed point version
+size_t msg_recv(MessageChannel *channel, double *values, size_t count);        ///< Double version
@@ -0,0 +1,192 @@
+/**
+ * \file
+ * \brief Screen renderer module source
+*/
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <io.h>
+#elif __linux__
+    #include <unistd.h>
+#else
+    #error "Your system case is not defined!"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "screen.hpp"
+
+
+/// Maximum length of cursor move sequence
+#define MOVE_SIZE 24
+
+/// Terminal clear sequence
+#define CLEAR_SEQ "\033[H\033[2J\033[3J"
+
+
+/**
+ * \brief Appends cursor move sequence to buffer
+ * \param [out] out Buffer to write in
+ * \param [in]  row Row number starting from 1
+ * \param [in]  col Column number starting from 1
+ * \return Pointer after written sequence
+*/
+static char *put_move(char *out, unsigned int row, unsigned int col);
+
+
+/**
+ * \brief Appends unsigned number to buffer
+ * \param [out] out Buffer to write in
+ * \param [in]  value Number to write
+ * \return Pointer after written number
+*/
+static char *put_uint(char *out, unsigned int value);
+
+
+/**
+ * \brief Writes whole buffer even if write() is interrupted
+ * \param [in] file Output file descriptor
+ * \param [in] buffer Data to write
+ * \param [in] size Data size
+ * \return Non zero value means error
+*/
+static int write_all(int file, const char *buffer, size_t size);
+
+
+
+
+int screen_constructor(Screen *screen, unsigned int width, unsigned int height, int file) {
+    if (!screen || !width || !height) return 1;
+
+    size_t size = (size_t) width * height;
+
+    screen -> frame = (unsigned char *) calloc(size, sizeof(unsigned char));
+    screen -> buffer = (char *) calloc(size * (MOVE_SIZE + 1) + MOVE_SIZE, sizeof(char));
+
+    if (!screen -> frame || !screen -> buffer) return 1;
+
+    screen -> width = width;
+    screen -> height = height;
+    screen -> valid = 0;
+    screen -> tty = isatty(file);
+    screen -> file = file;
+
+    return 0;
+}
+
+
+int screen_show(Screen *screen, const int *cells, int file) {
+    if (!screen || !cells) return 1;
+
+    char *out = screen -> buffer;
+
+    if (!screen -> tty) {
+        for(unsigned int y = 0; y < screen -> height; y++) {
+            for(unsigned int x = 0; x < screen -> width; x++)
+                *out++ = (char) *cells++;
+
+            *out++ = '\n';
+        }
+    }
+    else {
+        size_t size = (size_t) screen -> width * screen -> height;
+        size_t cursor = size;
+
+        for(size_t i = 0; i < size; i++) {
+            unsigned char cell = (unsigned char) cells[i];
+
+            if (cell < ' ' || cell == 127) cell = ' ';
+
+            if (screen -> valid && screen -> frame[i] == cell) continue;
+
+            if (cursor != i)
+                out = put_move(out, (unsigned int)(i / screen -> width) + 1, (unsigned int)(i % screen -> width) + 1);
+
+            *out++ = (char) cell;
+            screen -> frame[i] = cell;
+
+            // Terminal cursor position after the last column is not defined
+            cursor = ((i + 1) % screen -> width) ? i + 1 : size;
+        }
+
+        if (out != screen -> buffer)
+            out = put_move(out, screen -> height + 1, 1);
+
+        screen -> valid = 1;
+    }
+
+    fflush(stdout);
+
+    return write_all(file, screen -> buffer, (size_t)(out - screen -> buffer));
+}
+
+
+int screen_clear(Screen *screen, int file) {
+    if (!screen) return 1;
+
+    screen -> valid = 0;
+
+    if (!screen -> tty) return 0;
+
+    fflush(stdout);
+
+    return write_all(file, CLEAR_SEQ, sizeof(CLEAR_SEQ) - 1);
+}
+
+
+int screen_destructor(Screen *screen) {
+    if (!screen) return 1;
+
+    free(screen -> frame);
+    screen -> frame = nullptr;
+
+    free(screen -> buffer);
+    screen -> buffer = nullptr;
+
+    screen -> width = screen -> height = 0;
+    screen -> valid = 0;
+
+    return 0;
+}
+
+
+static char *put_move(char *out, unsigned int row, unsigned int col) {
+    *out++ = '\033';
+    *out++ = '[';
+    out = put_uint(out, row);
+    *out++ = ';';
+    out = put_uint(out, col);
+    *out++ = 'H';
+
+    return out;
+}
+
+
+static char *put_uint(char *out, unsigned int value) {
+    char digits[10] = {};
+    int count = 0;
+
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    while (count)
+        *out++ = digits[--count];
+
+    return out;
+}
+
+
+static int write_all(int file, const char *buffer, size_t size) {
+    while (size) {
+        ssize_t bytes = write(file, buffer, size);
+
+        if (bytes <= 0) return 1;
+
+        buffer += bytes;
+        size -= (size_t) bytes;
+    }
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * \file
+ * \brief Screen renderer module header
+*/
+
+
+/// Terminal screen which redraws only changed cells
+typedef struct {
+    unsigned int width = 0;         ///< Screen width in cells
+    unsigned int height = 0;        ///< Screen height in cells
+
+    unsigned char *frame = nullptr; ///< Previous frame
+    int valid = 0;                  ///< Previous frame is actually on the terminal
+
+    char *buffer = nullptr;         ///< Output buffer for one frame
+    int tty = 0;                    ///< Output file is terminal (otherwise frames are printed as plain text)
+    int file = -1;                  ///< Output file descriptor given to screen_constructor()
+} Screen;
+
+
+/**
+ * \brief Allocates screen buffers
+ * \param [out] screen Screen to construct
+ * \param [in]  width Screen width in cells
+ * \param [in]  height Screen height in cells
+ * \param [in]  file Output file descriptor
+ * \return Non zero value means error
+*/
+int screen_constructor(Screen *screen, unsigned int width, unsigned int height, int file);
+
+
+/**
+ * \brief Draws frame with one write() call
+ * \param [in] screen Screen to draw on
+ * \param [in] cells Array of width * height character codes
+ * \param [in] file Output file descriptor
+ * \note Only cells changed since previous frame are drawn on terminal
+ * \return Non zero value means error
+*/
+int screen_show(Screen *screen, const int *cells, int file);
+
+
+/**
+ * \brief Clears terminal with escape sequence
+ * \param [in] screen Screen to clear
+ * \param [in] file Output file descriptor
+ * \return Non zero value means error
+*/
+int screen_clear(Screen *screen, int file);
+
+
+/**
+ * \brief Frees screen buffers
+ * \param [in] screen Screen to destruct
+ * \return Non zero value means error
+*/
+int screen_destructor(Screen *screen);
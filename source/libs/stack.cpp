@@ -32,12 +32,22 @@ do {                                            \
  * \param [in] stack This stack will be resized automaticaly
  * \return Non zero value means error
 */
-static int stack_resize(Stack *stack);
+template <typename stack_data_t>
+static int stack_resize(Stack<stack_data_t> *stack);
 
 
+static void print_data(FILE *stream, int value)       { fprintf(stream, "%i", value); }   ///< Prints int element
+static void print_data(FILE *stream, long long value) { fprintf(stream, "%lli", value); } ///< Prints long long element
+static void print_data(FILE *stream, double value)    { fprintf(stream, "%g", value); }   ///< Prints double element
 
+static inline int is_poison(int value)       { return value == POISON_VALUE; }                          ///< Checks if int element is POISON_VALUE
+static inline int is_poison(long long value) { return value == POISON_VALUE; }                          ///< Checks if long long element is POISON_VALUE
+static inline int is_poison(double value)    { return value >= POISON_VALUE && value <= POISON_VALUE; } ///< Checks if double element is POISON_VALUE (without float equality warning)
 
-int stack_constructor(Stack *stack, int capacity) {
+
+
+template <typename stack_data_t>
+int stack_constructor(Stack<stack_data_t> *stack, int capacity) {
     CHECK(stack, return EXIT_CODES::INVALID_ARGUMENT);
     CHECK(capacity > 0, return EXIT_CODES::INVALID_ARGUMENT);
 
@@ -56,7 +66,8 @@ int stack_constructor(Stack *stack, int capacity) {
 }
 
 
-static int stack_resize(Stack *stack) {
+template <typename stack_data_t>
+static int stack_resize(Stack<stack_data_t> *stack) {
     RETURN_ON_ERROR(stack);
 
     if (4 * stack -> size < stack -> capacity)
@@ -80,7 +91,8 @@ static int stack_resize(Stack *stack) {
 }
 
 
-int stack_push(Stack *stack, stack_data_t new_data) {
+template <typename stack_data_t>
+int stack_push(Stack<stack_data_t> *stack, stack_data_t new_data) {
     RETURN_ON_ERROR(stack);
 
     (stack -> data)[(stack -> size)++] = new_data;
@@ -91,7 +103,8 @@ int stack_push(Stack *stack, stack_data_t new_data) {
 }
 
 
-int stack_pop(Stack *stack, stack_data_t *data) {
+template <typename stack_data_t>
+int stack_pop(Stack<stack_data_t> *stack, stack_data_t *data) {
     CHECK(data, return EXIT_CODES::INVALID_ARGUMENT);
 
     RETURN_ON_ERROR(stack);
@@ -107,7 +120,8 @@ int stack_pop(Stack *stack, stack_data_t *data) {
 }
 
 
-int stack_destructor(Stack *stack) {
+template <typename stack_data_t>
+int stack_destructor(Stack<stack_data_t> *stack) {
     RETURN_ON_ERROR(stack);
 
     free((char *)(stack -> data));
@@ -121,7 +135,8 @@ int stack_destructor(Stack *stack) {
 }
 
 
-int stack_verificator(Stack *stack) {
+template <typename stack_data_t>
+int stack_verificator(Stack<stack_data_t> *stack) {
     CHECK(stack, return EXIT_CODES::INVALID_ARGUMENT);
 
     CHECK(stack -> data, return EXIT_CODES::INVALID_DATA);
@@ -130,18 +145,25 @@ int stack_verificator(Stack *stack) {
 
     CHECK(stack -> size >= 0 && stack -> size <= stack -> capacity, return EXIT_CODES::INVALID_SIZE);
 
+#ifdef STACK_DEBUG
     for(int i = 0; i < stack -> capacity; i++) {
         if (i < stack -> size)
-            CHECK((stack -> data)[i] != POISON_VALUE, return EXIT_CODES::UNEXP_POISON_VAL);
+            CHECK(!is_poison((stack -> data)[i]), return EXIT_CODES::UNEXP_POISON_VAL);
         else
-            CHECK((stack -> data)[i] == POISON_VALUE, return EXIT_CODES::UNEXP_NORMAL_VAL);
+            CHECK(is_poison((stack -> data)[i]), return EXIT_CODES::UNEXP_NORMAL_VAL);
     }
+#else
+    // Push and pop change only elements next to size, so the others are checked in debug build only
+    CHECK(!stack -> size || !is_poison((stack -> data)[stack -> size - 1]), return EXIT_CODES::UNEXP_POISON_VAL);
+    CHECK(stack -> size == stack -> capacity || is_poison((stack -> data)[stack -> size]), return EXIT_CODES::UNEXP_NORMAL_VAL);
+#endif
     
     return 0;
 }
 
 
-void stack_dump(Stack *stack, int error, FILE *stream) {
+template <typename stack_data_t>
+void stack_dump(Stack<stack_data_t> *stack, int error, FILE *stream) {
     CHECK(stack, return);
     
     fprintf(stream, "Stack[%p]:\n", stack);
@@ -161,12 +183,28 @@ void stack_dump(Stack *stack, int error, FILE *stream) {
     for(int i = 0; i < stack -> capacity; i++) {
         fprintf(stream, "%4s[%03i] ", "", i); // stack_data_t index
 
-        fprintf(stream, OBJECT_TO_STR, (stack -> data)[i]); // print value function (possible macros)
+        print_data(stream, (stack -> data)[i]); // print value function (overloaded by type)
 
-        if ((stack -> data)[i] == POISON_VALUE) fprintf(stream, " (POISON VALUE)"); // poison value warning
+        if (is_poison((stack -> data)[i])) fprintf(stream, " (POISON VALUE)"); // poison value warning
             
         fputc('\n', stream); // new line
     }
 
     fputc('\n', stream);
 }
+
+
+/// Instantiates stack functions for element type
+#define INSTANTIATE_STACK(type)                                                         \
+    template int stack_constructor<type>(Stack<type> *stack, int capacity);             \
+    template int stack_push<type>(Stack<type> *stack, type object);                     \
+    template int stack_pop<type>(Stack<type> *stack, type *object);                     \
+    template int stack_destructor<type>(Stack<type> *stack);                            \
+    template int stack_verificator<type>(Stack<type> *stack);                           \
+    template void stack_dump<type>(Stack<type> *stack, int error, FILE *stream)
+
+INSTANTIATE_STACK(int);
+INSTANTIATE_STACK(long long);
+INSTANTIATE_STACK(double);
+
+#undef INSTANTIATE_STACK
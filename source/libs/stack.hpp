@@ -1,18 +1,14 @@
-/// Stack data type
-typedef int stack_data_t;
-
-
-/// Stack
-typedef struct {
+/// Stack of stack_data_t elements (instantiated for int, long long and double)
+template <typename stack_data_t>
+struct Stack {
     stack_data_t *data = nullptr;       ///< Array of stack_data_t elements
     int capacity       =       0;       ///< Maximum size
     int size           =       0;       ///< Actual number of elements
-} Stack;
+};
 
 
 #define POISON_VALUE 0xC0FFEE
 #define MAX_CAPACITY_VALUE 100000
-#define OBJECT_TO_STR "%i"
 
 
 /// Exit codes for stack functions
@@ -47,7 +43,8 @@ do {
  * \note Free stack before contsructor to prevent memory leak
  * \return Non zero value means error
 */
-int stack_constructor(Stack *stack, int capacity);
+template <typename stack_data_t>
+int stack_constructor(Stack<stack_data_t> *stack, int capacity);
 
 
 /**
@@ -57,7 +54,8 @@ int stack_constructor(Stack *stack, int capacity);
  * \note Stack will try to resize to hold all the objects
  * \return Non zero value means error
 */
-int stack_push(Stack *stack, stack_data_t object);
+template <typename stack_data_t>
+int stack_push(Stack<stack_data_t> *stack, stack_data_t object);
 
 
 /**
@@ -67,7 +65,8 @@ int stack_push(Stack *stack, stack_data_t object);
  * \note Stack will try to resize if hold too few objects for its size
  * \return Non zero value means error
 */
-int stack_pop(Stack *stack, stack_data_t *object);
+template <typename stack_data_t>
+int stack_pop(Stack<stack_data_t> *stack, stack_data_t *object);
 
 
 /**
@@ -76,7 +75,8 @@ int stack_pop(Stack *stack, stack_data_t *object);
  * \note Stack won't be free in case of verification error so get ready for memory leak
  * \return Non zero value means error
 */
-int stack_destructor(Stack *stack);
+template <typename stack_data_t>
+int stack_destructor(Stack<stack_data_t> *stack);
 
 
 /**
@@ -84,7 +84,8 @@ int stack_destructor(Stack *stack);
  * \param [in] stack Stack to check
  * \return Non zero value means error
 */
-int stack_verificator(Stack *stack);
+template <typename stack_data_t>
+int stack_verificator(Stack<stack_data_t> *stack);
 
 
 /**
@@ -93,4 +94,5 @@ int stack_verificator(Stack *stack);
  * \param [in]  error  This error code will be printed
  * \param [out] stream File to dump in
 */
-void stack_dump(Stack *stack, int error, FILE *stream);
+template <typename stack_data_t>
+void stack_dump(Stack<stack_data_t> *stack, int error, FILE *stream);
@@ -0,0 +1,359 @@
+/**
+ * \file
+ * \brief OS thread module source
+*/
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+#elif __linux__
+    #include <pthread.h>
+    #include <sched.h>
+    #include <unistd.h>
+#else
+    #error "Your system case is not defined!"
+#endif
+
+#include <stdlib.h>
+#include "thread.hpp"
+
+
+#if defined(_WIN32) || defined(_WIN64)
+
+/// Calls thread function
+static DWORD WINAPI thread_entry(LPVOID thread) {
+    ((Thread *) thread) -> function(((Thread *) thread) -> arg);
+    return 0;
+}
+
+#else
+
+/// Calls thread function
+static void *thread_entry(void *thread) {
+    ((Thread *) thread) -> function(((Thread *) thread) -> arg);
+    return nullptr;
+}
+
+#endif
+
+
+#if defined(_WIN32) || defined(_WIN64)
+
+/// Lock and condition variable of monitor
+typedef struct {
+    SRWLOCK lock;               ///< Lock
+    CONDITION_VARIABLE cond;    ///< Condition variable
+} MonitorSync;
+
+#else
+
+/// Lock and condition variable of monitor
+typedef struct {
+    pthread_mutex_t lock;       ///< Lock
+    pthread_cond_t cond;        ///< Condition variable
+} MonitorSync;
+
+#endif
+
+
+/// Waits for tasks and executes them until pool stops
+static void pool_main(void *arg) {
+    ThreadPool *pool = (ThreadPool *) arg;
+
+    size_t worker = __atomic_fetch_add(&pool -> started, 1, __ATOMIC_SEQ_CST);
+    size_t generation = 0;
+
+    for(;;) {
+        monitor_lock(&pool -> monitor);
+
+        while (!pool -> stop && pool -> generation == generation)
+            monitor_wait(&pool -> monitor);
+
+        if (pool -> stop) {
+            monitor_unlock(&pool -> monitor);
+            return;
+        }
+
+        generation = pool -> generation;
+
+        task_function_t task = pool -> task;
+        void *task_arg = pool -> arg;
+        size_t workers = pool -> count + 1;
+
+        monitor_unlock(&pool -> monitor);
+
+        task(task_arg, worker, workers);
+
+        monitor_lock(&pool -> monitor);
+
+        if (--pool -> pending == 0)
+            monitor_wake(&pool -> monitor);
+
+        monitor_unlock(&pool -> monitor);
+    }
+}
+
+
+
+
+int thread_start(Thread *thread, thread_function_t function, void *arg) {
+    if (!thread || !function) return 1;
+
+    thread -> function = function;
+    thread -> arg = arg;
+
+#if defined(_WIN32) || defined(_WIN64)
+    thread -> handle = CreateThread(nullptr, 0, &thread_entry, thread, 0, nullptr);
+
+    return !thread -> handle;
+#else
+    pthread_t *handle = (pthread_t *) calloc(1, sizeof(pthread_t));
+
+    if (!handle) return 1;
+
+    if (pthread_create(handle, nullptr, &thread_entry, thread)) {
+        free(handle);
+        return 1;
+    }
+
+    thread -> handle = handle;
+
+    return 0;
+#endif
+}
+
+
+int thread_join(Thread *thread) {
+    if (!thread || !thread -> handle) return 1;
+
+#if defined(_WIN32) || defined(_WIN64)
+    int error = WaitForSingleObject(thread -> handle, INFINITE) != WAIT_OBJECT_0;
+
+    CloseHandle(thread -> handle);
+#else
+    int error = pthread_join(*(pthread_t *) thread -> handle, nullptr);
+
+    free(thread -> handle);
+#endif
+
+    thread -> handle = nullptr;
+
+    return error;
+}
+
+
+
+int monitor_constructor(Monitor *monitor) {
+    if (!monitor) return 1;
+
+    MonitorSync *sync = (MonitorSync *) calloc(1, sizeof(MonitorSync));
+
+    if (!sync) return 1;
+
+#if defined(_WIN32) || defined(_WIN64)
+    InitializeSRWLock(&sync -> lock);
+    InitializeConditionVariable(&sync -> cond);
+#else
+    if (pthread_mutex_init(&sync -> lock, nullptr) || pthread_cond_init(&sync -> cond, nullptr)) {
+        free(sync);
+        return 1;
+    }
+#endif
+
+    monitor -> sync = sync;
+
+    return 0;
+}
+
+
+int monitor_forget(Monitor *monitor) {
+    if (!monitor) return 1;
+
+    *monitor = {};
+
+    return monitor_constructor(monitor);
+}
+
+
+void monitor_destructor(Monitor *monitor) {
+    if (!monitor || !monitor -> sync) return;
+
+#if defined(__linux__)
+    pthread_mutex_destroy(&((MonitorSync *) monitor -> sync) -> lock);
+    pthread_cond_destroy(&((MonitorSync *) monitor -> sync) -> cond);
+#endif
+
+    free(monitor -> sync);
+
+    monitor -> sync = nullptr;
+}
+
+
+void monitor_lock(Monitor *monitor) {
+#if defined(_WIN32) || defined(_WIN64)
+    AcquireSRWLockExclusive(&((MonitorSync *) monitor -> sync) -> lock);
+#else
+    pthread_mutex_lock(&((MonitorSync *) monitor -> sync) -> lock);
+#endif
+}
+
+
+void monitor_unlock(Monitor *monitor) {
+#if defined(_WIN32) || defined(_WIN64)
+    ReleaseSRWLockExclusive(&((MonitorSync *) monitor -> sync) -> lock);
+#else
+    pthread_mutex_unlock(&((MonitorSync *) monitor -> sync) -> lock);
+#endif
+}
+
+
+void monitor_wait(Monitor *monitor) {
+    MonitorSync *sync = (MonitorSync *) monitor -> sync;
+
+#if defined(_WIN32) || defined(_WIN64)
+    SleepConditionVariableSRW(&sync -> cond, &sync -> lock, INFINITE, 0);
+#else
+    pthread_cond_wait(&sync -> cond, &sync -> lock);
+#endif
+}
+
+
+void monitor_wake(Monitor *monitor) {
+#if defined(_WIN32) || defined(_WIN64)
+    WakeAllConditionVariable(&((MonitorSync *) monitor -> sync) -> cond);
+#else
+    pthread_cond_broadcast(&((MonitorSync *) monitor -> sync) -> cond);
+#endif
+}
+
+
+void thread_yield() {
+#if defined(_WIN32) || defined(_WIN64)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+
+void thread_backoff(size_t attempt) {
+    if (attempt < 16) {
+        thread_yield();
+        return;
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    Sleep(1);
+#else
+    usleep((attempt < 1000) ? (useconds_t) attempt : 1000);
+#endif
+}
+
+
+size_t thread_hardware_count() {
+#if defined(_WIN32) || defined(_WIN64)
+    SYSTEM_INFO info = {};
+    GetSystemInfo(&info);
+
+    return (info.dwNumberOfProcessors) ? info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (count > 0) ? (size_t) count : 1;
+#endif
+}
+
+
+int pool_constructor(ThreadPool *pool, size_t count) {
+    if (!pool) return 1;
+
+    *pool = {};
+
+    if (monitor_constructor(&pool -> monitor)) return 1;
+
+    pool -> count = count;
+
+    return 0;
+}
+
+
+int pool_run(ThreadPool *pool, task_function_t task, void *arg) {
+    if (!pool || !pool -> monitor.sync || !task) return 1;
+
+    int idle = 0;
+
+    if (!__atomic_compare_exchange_n(&pool -> busy, &idle, 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) return 1;
+
+    if (!pool -> threads && pool -> count) {
+        pool -> threads = (Thread *) calloc(pool -> count, sizeof(Thread));
+
+        size_t started = 0;
+
+        while (pool -> threads && started < pool -> count && !thread_start(pool -> threads + started, &pool_main, pool))
+            started++;
+
+        // Pool works with threads that were started
+        pool -> count = started;
+    }
+
+    monitor_lock(&pool -> monitor);
+
+    pool -> task = task;
+    pool -> arg = arg;
+    pool -> pending = pool -> count;
+    pool -> generation++;
+
+    monitor_wake(&pool -> monitor);
+    monitor_unlock(&pool -> monitor);
+
+    task(arg, pool -> count, pool -> count + 1);
+
+    monitor_lock(&pool -> monitor);
+
+    while (pool -> pending)
+        monitor_wait(&pool -> monitor);
+
+    monitor_unlock(&pool -> monitor);
+
+    __atomic_store_n(&pool -> busy, 0, __ATOMIC_SEQ_CST);
+
+    return 0;
+}
+
+
+int pool_forget(ThreadPool *pool) {
+    if (!pool || !pool -> monitor.sync) return 1;
+
+    free(pool -> threads);
+
+    pool -> threads = nullptr;
+    pool -> task = nullptr;
+    pool -> arg = nullptr;
+    pool -> generation = 0;
+    pool -> pending = 0;
+    pool -> started = 0;
+    pool -> stop = 0;
+    pool -> busy = 0;
+
+    return monitor_forget(&pool -> monitor);
+}
+
+
+void pool_destructor(ThreadPool *pool) {
+    if (!pool || !pool -> monitor.sync) return;
+
+    monitor_lock(&pool -> monitor);
+
+    pool -> stop = 1;
+
+    monitor_wake(&pool -> monitor);
+    monitor_unlock(&pool -> monitor);
+
+    for(size_t i = 0; pool -> threads && i < pool -> count; i++)
+        thread_join(pool -> threads + i);
+
+    free(pool -> threads);
+
+    monitor_destructor(&pool -> monitor);
+
+    *pool = {};
+}
@@ -0,0 +1,143 @@
+/**
+ * \file
+ * \brief OS thread module header
+*/
+
+
+/// Function executed by thread
+typedef void (*thread_function_t)(void *arg);
+
+
+/// OS thread
+typedef struct {
+    void *handle = nullptr;                 ///< Platform thread handle
+    thread_function_t function = nullptr;   ///< Function to execute
+    void *arg = nullptr;                    ///< Function argument
+} Thread;
+
+
+/**
+ * \brief Starts thread
+ * \param [out] thread Thread to start
+ * \param [in]  function Function to execute
+ * \param [in]  arg Function argument
+ * \return Non zero value means error
+*/
+int thread_start(Thread *thread, thread_function_t function, void *arg);
+
+
+/**
+ * \brief Waits for thread to finish and frees its handle
+ * \param [in] thread Thread started by thread_start()
+ * \return Non zero value means error
+*/
+int thread_join(Thread *thread);
+
+
+
+/**
+ * \brief Gives the rest of time slice to other threads
+*/
+void thread_yield();
+
+
+/**
+ * \brief Waits before the next attempt to take busy resource
+ * \param [in] attempt Number of failed attempts (first attempts give time slice, next ones sleep longer up to a millisecond)
+*/
+void thread_backoff(size_t attempt);
+
+
+/**
+ * \brief Returns number of hardware threads (at least one)
+*/
+size_t thread_hardware_count();
+
+
+/// Lock with condition variable
+typedef struct {
+    void *sync = nullptr;               ///< Platform lock and condition variable
+} Monitor;
+
+
+/**
+ * \brief Creates monitor
+ * \param [out] monitor Monitor to create
+ * \return Non zero value means error
+*/
+int monitor_constructor(Monitor *monitor);
+
+
+/**
+ * \brief Frees monitor
+ * \param [in] monitor Monitor to free
+*/
+void monitor_destructor(Monitor *monitor);
+
+
+/**
+ * \brief Replaces monitor inherited by child process created by fork() with new one
+ * \param monitor Monitor to replace
+ * \note Inherited monitor can be locked or waited by threads that child process doesn't have, so it is not freed
+ * \return Non zero value means error
+*/
+int monitor_forget(Monitor *monitor);
+
+
+void monitor_lock(Monitor *monitor);    ///< Acquires monitor lock
+void monitor_unlock(Monitor *monitor);  ///< Releases monitor lock
+void monitor_wait(Monitor *monitor);    ///< Releases lock until monitor_wake() is called by other thread
+void monitor_wake(Monitor *monitor);    ///< Wakes all threads waiting in monitor_wait()
+
+
+/// Task executed by every worker of thread pool
+typedef void (*task_function_t)(void *arg, size_t worker, size_t workers);
+
+
+/// Pool of threads that execute the same task
+typedef struct {
+    Thread *threads = nullptr;          ///< Pool threads (started by the first pool_run())
+    size_t count = 0;                   ///< Pool thread count
+    Monitor monitor = {};               ///< Protects pool state
+    task_function_t task = nullptr;     ///< Current task
+    void *arg = nullptr;                ///< Current task argument
+    size_t generation = 0;              ///< Number of tasks given to pool
+    size_t pending = 0;                 ///< Threads that have not finished current task
+    size_t started = 0;                 ///< Threads that took their worker index
+    int stop = 0;                       ///< Pool threads have to exit
+    int busy = 0;                       ///< Pool is running task
+} ThreadPool;
+
+
+/**
+ * \brief Creates pool, threads are started on first use
+ * \param [out] pool Pool to create
+ * \param [in]  count Pool thread count
+ * \return Non zero value means error
+*/
+int pool_constructor(ThreadPool *pool, size_t count);
+
+
+/**
+ * \brief Executes task on all pool threads and on calling thread and waits for all of them
+ * \param pool Pool created by pool_constructor()
+ * \param [in] task Task to execute (calling thread is the last worker)
+ * \param [in] arg Task argument
+ * \return Non zero value means that pool is busy with other task and task was not executed
+*/
+int pool_run(ThreadPool *pool, task_function_t task, void *arg);
+
+
+/**
+ * \brief Forgets pool threads in child process created by fork(), new threads are started by the next pool_run()
+ * \param pool Pool inherited from parent process
+ * \return Non zero value means error
+*/
+int pool_forget(ThreadPool *pool);
+
+
+/**
+ * \brief Stops pool threads and frees pool
+ * \param [in] pool Pool to free
+*/
+void pool_destructor(ThreadPool *pool);
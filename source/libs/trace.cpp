@@ -0,0 +1,111 @@
+/**
+ * \file
+ * \brief Execution trace module source
+*/
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <io.h>
+#elif __linux__
+    #include <unistd.h>
+#else
+    #error "Your system case is not defined!"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include "trace.hpp"
+
+
+/// Trace that will be written on SIGUSR1
+static const Trace *SIGNAL_TRACE = nullptr;
+
+/// File for SIGUSR1 trace
+static int SIGNAL_FILE = -1;
+
+
+/**
+ * \brief Writes SIGNAL_TRACE to SIGNAL_FILE
+ * \param [in] sig Signal number
+*/
+static void trace_signal_handler(int sig);
+
+
+
+
+int trace_constructor(Trace *trace, size_t size) {
+    if (!trace || !size) return 1;
+
+    size_t capacity = 1;
+
+    while (capacity < size) capacity <<= 1;
+
+    trace -> records = (TraceRecord *) calloc(capacity, sizeof(TraceRecord));
+
+    if (!trace -> records) return 1;
+
+    trace -> mask = capacity - 1;
+    trace -> count = 0;
+
+    return 0;
+}
+
+
+int trace_write(const Trace *trace, int file) {
+    if (!trace || !trace -> records || file < 0) return 1;
+
+    size_t count = trace -> count;
+    size_t size = (count > trace -> mask) ? trace -> mask + 1 : count;
+    int version = TRACE_VERSION;
+
+    size_t bytes = 0, expected_bytes = sizeof(TRACE_SIGN) + 2 * sizeof(int) + 2 * sizeof(size_t) + size * sizeof(TraceRecord);
+
+    bytes += write(file, TRACE_SIGN, sizeof(TRACE_SIGN));
+    bytes += write(file, &version, sizeof(int));
+    bytes += write(file, &trace -> precision, sizeof(int));
+    bytes += write(file, &count, sizeof(size_t));
+    bytes += write(file, &size, sizeof(size_t));
+
+    // Oldest record is right after the newest one
+    size_t start = (count - size) & trace -> mask;
+    size_t first = (start + size > trace -> mask + 1) ? trace -> mask + 1 - start : size;
+
+    bytes += write(file, trace -> records + start, first * sizeof(TraceRecord));
+
+    if (first < size)
+        bytes += write(file, trace -> records, (size - first) * sizeof(TraceRecord));
+
+    return bytes != expected_bytes;
+}
+
+
+int trace_set_signal(const Trace *trace, int file) {
+    if (!trace || file < 0) return 1;
+
+    SIGNAL_TRACE = trace;
+    SIGNAL_FILE = file;
+
+#ifdef SIGUSR1
+    if (signal(SIGUSR1, &trace_signal_handler) == SIG_ERR) return 1;
+#endif
+
+    return 0;
+}
+
+
+static void trace_signal_handler(int sig) {
+    trace_write(SIGNAL_TRACE, SIGNAL_FILE);
+}
+
+
+int trace_destructor(Trace *trace) {
+    if (!trace) return 1;
+
+    free(trace -> records);
+    trace -> records = nullptr;
+
+    trace -> mask = 0;
+    trace -> count = 0;
+
+    return 0;
+}
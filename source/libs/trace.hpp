@@ -0,0 +1,86 @@
+/**
+ * \file
+ * \brief Execution trace module header
+*/
+
+
+/// Trace file signature
+#define TRACE_SIGN "AT-TRC"
+
+/// Trace file version
+#define TRACE_VERSION 3
+
+/// Default number of records in trace ring buffer
+#define TRACE_SIZE 4096
+
+
+/// One executed instruction
+typedef struct {
+    unsigned int offset = 0;    ///< Instruction offset
+    int top = 0;                ///< Top of value stack before execution
+    unsigned short code = 0;    ///< Command code
+    unsigned char flags = 0;    ///< Argument type bits
+} TraceRecord;
+
+
+/// Fixed size ring buffer of executed instructions
+typedef struct {
+    TraceRecord *records = nullptr; ///< Ring buffer
+    size_t mask = 0;                ///< Capacity - 1 (capacity is always power of two)
+    size_t count = 0;               ///< Total number of recorded instructions
+    int precision = 1000;           ///< Fixed point precision of recorded values
+} Trace;
+
+
+/**
+ * \brief Allocates trace buffer
+ * \param [out] trace Trace to construct
+ * \param [in]  size Minimal number of records (will be rounded up to power of two)
+ * \return Non zero value means error
+*/
+int trace_constructor(Trace *trace, size_t size);
+
+
+/**
+ * \brief Writes last records in binary format
+ * \param [in] trace Trace to write
+ * \param [in] file Output file descriptor
+ * \note Uses only write() so it can be called from signal handler
+ * \return Non zero value means error
+*/
+int trace_write(const Trace *trace, int file);
+
+
+/**
+ * \brief Writes trace to the file every time process gets SIGUSR1
+ * \param [in] trace Trace to write
+ * \param [in] file Output file descriptor
+ * \return Non zero value means error
+*/
+int trace_set_signal(const Trace *trace, int file);
+
+
+/**
+ * \brief Frees trace buffer
+ * \param [in] trace Trace to destruct
+ * \return Non zero value means error
+*/
+int trace_destructor(Trace *trace);
+
+
+/**
+ * \brief Adds record to the ring buffer overwriting the oldest one
+ * \param [out] trace Trace to add record in
+ * \param [in]  offset Instruction offset
+ * \param [in]  code Command code
+ * \param [in]  flags Argument type bits
+ * \param [in]  top Top of value stack
+*/
+inline void trace_record(Trace *trace, size_t offset, unsigned int code, unsigned char flags, int top) {
+    TraceRecord *record = trace -> records + (trace -> count++ & trace -> mask);
+
+    record -> offset = (unsigned int) offset;
+    record -> top = top;
+    record -> code = (unsigned short) code;
+    record -> flags = flags;
+}
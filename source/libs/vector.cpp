@@ -0,0 +1,419 @@
+/**
+ * \file
+ * \brief Bulk memory kernels module source
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "vector.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define VECTOR_X86 1
+
+    #include <immintrin.h>
+#else
+    #define VECTOR_X86 0
+#endif
+
+
+/// Scalar kernels
+/// Arithmetic goes through unsigned types so overflow wraps around like in SIMD kernels
+///@{
+static void scalar_fill(int *dst, int value, size_t count);
+static void scalar_add(int *dst, const int *a, const int *b, size_t count);
+static void scalar_sub(int *dst, const int *a, const int *b, size_t count);
+static void scalar_mul(int *dst, const int *a, const int *b, size_t count, int precision);
+static long long scalar_dot(const int *a, const int *b, size_t count);
+static long long scalar_sum(const int *src, size_t count);
+static int scalar_min(const int *src, size_t count);
+static int scalar_max(const int *src, size_t count);
+///@}
+
+
+/// Portable kernels table
+static const VectorKernels SCALAR_KERNELS = {
+    "scalar",
+    &scalar_fill, &scalar_add, &scalar_sub, &scalar_mul,
+    &scalar_dot, &scalar_sum, &scalar_min, &scalar_max
+};
+
+
+#if VECTOR_X86
+
+/// SSE4.1 kernels
+///@{
+static void sse_fill(int *dst, int value, size_t count);
+static void sse_add(int *dst, const int *a, const int *b, size_t count);
+static void sse_sub(int *dst, const int *a, const int *b, size_t count);
+static long long sse_dot(const int *a, const int *b, size_t count);
+static long long sse_sum(const int *src, size_t count);
+static int sse_min(const int *src, size_t count);
+static int sse_max(const int *src, size_t count);
+///@}
+
+
+/// AVX2 kernels
+///@{
+static void avx_fill(int *dst, int value, size_t count);
+static void avx_add(int *dst, const int *a, const int *b, size_t count);
+static void avx_sub(int *dst, const int *a, const int *b, size_t count);
+static long long avx_dot(const int *a, const int *b, size_t count);
+static long long avx_sum(const int *src, size_t count);
+static int avx_min(const int *src, size_t count);
+static int avx_max(const int *src, size_t count);
+///@}
+
+
+/// SSE4.1 kernels table
+/// Fixed point multiplication divides 64 bit products by precision which has no SIMD equivalent
+static const VectorKernels SSE_KERNELS = {
+    "sse4.1",
+    &sse_fill, &sse_add, &sse_sub, &scalar_mul,
+    &sse_dot, &sse_sum, &sse_min, &sse_max
+};
+
+
+/// AVX2 kernels table
+static const VectorKernels AVX_KERNELS = {
+    "avx2",
+    &avx_fill, &avx_add, &avx_sub, &scalar_mul,
+    &avx_dot, &avx_sum, &avx_min, &avx_max
+};
+
+#endif
+
+
+
+
+const VectorKernels *get_vector_kernels() {
+#if VECTOR_X86
+    static const VectorKernels *kernels = (__builtin_cpu_init(), __builtin_cpu_supports("avx2")) ? &AVX_KERNELS :
+                                          (__builtin_cpu_supports("sse4.1")) ? &SSE_KERNELS : &SCALAR_KERNELS;
+    return kernels;
+#else
+    return &SCALAR_KERNELS;
+#endif
+}
+
+
+const VectorKernels *get_scalar_kernels() {
+    return &SCALAR_KERNELS;
+}
+
+
+static void scalar_fill(int *dst, int value, size_t count) {
+    for(size_t i = 0; i < count; i++)
+        dst[i] = value;
+}
+
+
+static void scalar_add(int *dst, const int *a, const int *b, size_t count) {
+    for(size_t i = 0; i < count; i++)
+        dst[i] = (int)((unsigned int) a[i] + (unsigned int) b[i]);
+}
+
+
+static void scalar_sub(int *dst, const int *a, const int *b, size_t count) {
+    for(size_t i = 0; i < count; i++)
+        dst[i] = (int)((unsigned int) a[i] - (unsigned int) b[i]);
+}
+
+
+static void scalar_mul(int *dst, const int *a, const int *b, size_t count, int precision) {
+    for(size_t i = 0; i < count; i++)
+        dst[i] = (int)((long long) a[i] * (long long) b[i] / precision);
+}
+
+
+static long long scalar_dot(const int *a, const int *b, size_t count) {
+    unsigned long long sum = 0;
+
+    for(size_t i = 0; i < count; i++)
+        sum += (unsigned long long)((long long) a[i] * (long long) b[i]);
+
+    return (long long) sum;
+}
+
+
+static long long scalar_sum(const int *src, size_t count) {
+    unsigned long long sum = 0;
+
+    for(size_t i = 0; i < count; i++)
+        sum += (unsigned long long)(long long) src[i];
+
+    return (long long) sum;
+}
+
+
+static int scalar_min(const int *src, size_t count) {
+    int value = src[0];
+
+    for(size_t i = 1; i < count; i++)
+        if (src[i] < value) value = src[i];
+
+    return value;
+}
+
+
+static int scalar_max(const int *src, size_t count) {
+    int value = src[0];
+
+    for(size_t i = 1; i < count; i++)
+        if (src[i] > value) value = src[i];
+
+    return value;
+}
+
+
+#if VECTOR_X86
+
+__attribute__((target("sse4.1")))
+static void sse_fill(int *dst, int value, size_t count) {
+    __m128i v = _mm_set1_epi32(value);
+    size_t i = 0;
+
+    for(; i + 4 <= count; i += 4)
+        _mm_storeu_si128((__m128i *)(dst + i), v);
+
+    scalar_fill(dst + i, value, count - i);
+}
+
+
+__attribute__((target("sse4.1")))
+static void sse_add(int *dst, const int *a, const int *b, size_t count) {
+    size_t i = 0;
+
+    for(; i + 4 <= count; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_add_epi32(va, vb));
+    }
+
+    scalar_add(dst + i, a + i, b + i, count - i);
+}
+
+
+__attribute__((target("sse4.1")))
+static void sse_sub(int *dst, const int *a, const int *b, size_t count) {
+    size_t i = 0;
+
+    for(; i + 4 <= count; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_sub_epi32(va, vb));
+    }
+
+    scalar_sub(dst + i, a + i, b + i, count - i);
+}
+
+
+__attribute__((target("sse4.1")))
+static long long sse_dot(const int *a, const int *b, size_t count) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for(; i + 4 <= count; i += 4) {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+
+        acc = _mm_add_epi64(acc, _mm_mul_epi32(va, vb));
+        acc = _mm_add_epi64(acc, _mm_mul_epi32(_mm_srli_epi64(va, 32), _mm_srli_epi64(vb, 32)));
+    }
+
+    long long lanes[2] = {};
+    _mm_storeu_si128((__m128i *) lanes, acc);
+
+    return (long long)((unsigned long long) lanes[0] + (unsigned long long) lanes[1] + (unsigned long long) scalar_dot(a + i, b + i, count - i));
+}
+
+
+__attribute__((target("sse4.1")))
+static long long sse_sum(const int *src, size_t count) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+
+    for(; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(src + i));
+
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(v));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(v, 8)));
+    }
+
+    long long lanes[2] = {};
+    _mm_storeu_si128((__m128i *) lanes, acc);
+
+    return (long long)((unsigned long long) lanes[0] + (unsigned long long) lanes[1] + (unsigned long long) scalar_sum(src + i, count - i));
+}
+
+
+__attribute__((target("sse4.1")))
+static int sse_min(const int *src, size_t count) {
+    if (count < 4) return scalar_min(src, count);
+
+    __m128i acc = _mm_loadu_si128((const __m128i *) src);
+    size_t i = 4;
+
+    for(; i + 4 <= count; i += 4)
+        acc = _mm_min_epi32(acc, _mm_loadu_si128((const __m128i *)(src + i)));
+
+    int lanes[5] = {};
+    _mm_storeu_si128((__m128i *) lanes, acc);
+
+    if (i == count) return scalar_min(lanes, 4);
+
+    lanes[4] = scalar_min(src + i, count - i);
+
+    return scalar_min(lanes, 5);
+}
+
+
+__attribute__((target("sse4.1")))
+static int sse_max(const int *src, size_t count) {
+    if (count < 4) return scalar_max(src, count);
+
+    __m128i acc = _mm_loadu_si128((const __m128i *) src);
+    size_t i = 4;
+
+    for(; i + 4 <= count; i += 4)
+        acc = _mm_max_epi32(acc, _mm_loadu_si128((const __m128i *)(src + i)));
+
+    int lanes[5] = {};
+    _mm_storeu_si128((__m128i *) lanes, acc);
+
+    if (i == count) return scalar_max(lanes, 4);
+
+    lanes[4] = scalar_max(src + i, count - i);
+
+    return scalar_max(lanes, 5);
+}
+
+
+__attribute__((target("avx2")))
+static void avx_fill(int *dst, int value, size_t count) {
+    __m256i v = _mm256_set1_epi32(value);
+    size_t i = 0;
+
+    for(; i + 8 <= count; i += 8)
+        _mm256_storeu_si256((__m256i *)(dst + i), v);
+
+    scalar_fill(dst + i, value, count - i);
+}
+
+
+__attribute__((target("avx2")))
+static void avx_add(int *dst, const int *a, const int *b, size_t count) {
+    size_t i = 0;
+
+    for(; i + 8 <= count; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_add_epi32(va, vb));
+    }
+
+    scalar_add(dst + i, a + i, b + i, count - i);
+}
+
+
+__attribute__((target("avx2")))
+static void avx_sub(int *dst, const int *a, const int *b, size_t count) {
+    size_t i = 0;
+
+    for(; i + 8 <= count; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_sub_epi32(va, vb));
+    }
+
+    scalar_sub(dst + i, a + i, b + i, count - i);
+}
+
+
+__attribute__((target("avx2")))
+static long long avx_dot(const int *a, const int *b, size_t count) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for(; i + 8 <= count; i += 8) {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(va, vb));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(_mm256_srli_epi64(va, 32), _mm256_srli_epi64(vb, 32)));
+    }
+
+    long long lanes[4] = {};
+    _mm256_storeu_si256((__m256i *) lanes, acc);
+
+    unsigned long long sum = (unsigned long long) scalar_dot(a + i, b + i, count - i);
+
+    for(int l = 0; l < 4; l++)
+        sum += (unsigned long long) lanes[l];
+
+    return (long long) sum;
+}
+
+
+__attribute__((target("avx2")))
+static long long avx_sum(const int *src, size_t count) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for(; i + 8 <= count; i += 8) {
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(src + i))));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(src + i + 4))));
+    }
+
+    long long lanes[4] = {};
+    _mm256_storeu_si256((__m256i *) lanes, acc);
+
+    unsigned long long sum = (unsigned long long) scalar_sum(src + i, count - i);
+
+    for(int l = 0; l < 4; l++)
+        sum += (unsigned long long) lanes[l];
+
+    return (long long) sum;
+}
+
+
+__attribute__((target("avx2")))
+static int avx_min(const int *src, size_t count) {
+    if (count < 8) return scalar_min(src, count);
+
+    __m256i acc = _mm256_loadu_si256((const __m256i *) src);
+    size_t i = 8;
+
+    for(; i + 8 <= count; i += 8)
+        acc = _mm256_min_epi32(acc, _mm256_loadu_si256((const __m256i *)(src + i)));
+
+    int lanes[9] = {};
+    _mm256_storeu_si256((__m256i *) lanes, acc);
+
+    if (i == count) return scalar_min(lanes, 8);
+
+    lanes[8] = scalar_min(src + i, count - i);
+
+    return scalar_min(lanes, 9);
+}
+
+
+__attribute__((target("avx2")))
+static int avx_max(const int *src, size_t count) {
+    if (count < 8) return scalar_max(src, count);
+
+    __m256i acc = _mm256_loadu_si256((const __m256i *) src);
+    size_t i = 8;
+
+    for(; i + 8 <= count; i += 8)
+        acc = _mm256_max_epi32(acc, _mm256_loadu_si256((const __m256i *)(src + i)));
+
+    int lanes[9] = {};
+    _mm256_storeu_si256((__m256i *) lanes, acc);
+
+    if (i == count) return scalar_max(lanes, 8);
+
+    lanes[8] = scalar_max(src + i, count - i);
+
+    return scalar_max(lanes, 9);
+}
+
+#endif
@@ -0,0 +1,34 @@
+/**
+ * \file
+ * \brief Bulk memory kernels module header
+*/
+
+
+/// Set of bulk operations over arrays of fixed point numbers
+typedef struct {
+    const char *name;                                                                       ///< Instruction set name
+    void (*fill)(int *dst, int value, size_t count);                                        ///< dst[i] = value
+    void (*add)(int *dst, const int *a, const int *b, size_t count);                        ///< dst[i] = a[i] + b[i]
+    void (*sub)(int *dst, const int *a, const int *b, size_t count);                        ///< dst[i] = a[i] - b[i]
+    void (*mul)(int *dst, const int *a, const int *b, size_t count, int precision);         ///< dst[i] = a[i] * b[i] / precision
+    long long (*dot)(const int *a, const int *b, size_t count);                             ///< Sum of a[i] * b[i]
+    long long (*sum)(const int *src, size_t count);                                         ///< Sum of src[i]
+    int (*min)(const int *src, size_t count);                                               ///< Minimum of src[i] (count > 0)
+    int (*max)(const int *src, size_t count);                                               ///< Maximum of src[i] (count > 0)
+} VectorKernels;
+
+
+/**
+ * \brief Returns kernels for the best instruction set supported by CPU
+ * \note CPU features are detected on the first call only
+ * \note dst may coincide with a or b, but partially overlapping ranges give undefined result
+ * \return Pointer to static kernels table
+*/
+const VectorKernels *get_vector_kernels();
+
+
+/**
+ * \brief Returns portable kernels
+ * \return Pointer to static kernels table
+*/
+const VectorKernels *get_scalar_kernels();
@@ -0,0 +1,346 @@
+/**
+ * \file
+ * \brief Native functions: NCALL calls host function registered by name, arguments and results are passed through value stack
+ * \note Names are checked at load time, so unknown function stops program before execution
+ * \note Include it after Process and execute() are declared
+*/
+
+
+/// Size of native function table (power of two)
+const size_t NATIVE_FUNCTIONS = 256;
+
+
+/// Arguments, results and RAM given to native function (cells have type of the program)
+typedef struct {
+    int cell = CELL_FIXED32;        ///< One of CELL_TYPE
+    const Fixed *fixed = nullptr;   ///< Fixed point format
+    void *ram = nullptr;            ///< Process RAM
+    size_t ram_size = 0;            ///< RAM size in cells
+    const void *args = nullptr;     ///< Arguments in push order
+    void *results = nullptr;        ///< Results in push order
+} NativeCall;
+
+
+/// Host function (non zero value means error)
+typedef int (*native_t)(NativeCall *call);
+
+
+/// Registered native function
+typedef struct {
+    const char *name = nullptr;     ///< Name written after NCALL
+    arg_t hash = 0;                 ///< Name hash
+    native_t function = nullptr;    ///< Function (nullptr for free entry)
+    size_t args = 0;                ///< Values popped from stack before call
+    size_t results = 0;             ///< Values pushed to stack after call
+} NativeFunction;
+
+
+/// Registered functions (open addressing by name hash)
+static NativeFunction NATIVES[NATIVE_FUNCTIONS] = {};
+
+
+/**
+ * \brief Registers host function for NCALL (call it before program is started)
+ * \param [in] name Function name (string is not copied)
+ * \param [in] function Function
+ * \param [in] args Values popped from stack and given to function
+ * \param [in] results Values pushed to stack after call
+ * \return Non zero value means error
+*/
+int native_register(const char *name, native_t function, size_t args, size_t results);
+
+
+/**
+ * \brief Finds registered function
+ * \param [in] hash Name hash
+ * \return Function or nullptr
+*/
+const NativeFunction *native_find(arg_t hash);
+
+
+/// Converts argument to integer rounding towards zero
+long long native_int(const NativeCall *call, size_t index);
+
+/// Converts argument to double
+double native_real(const NativeCall *call, size_t index);
+
+/// Sets result to integer
+void native_set_int(NativeCall *call, size_t index, long long value);
+
+/**
+ * \brief Sets result to double (fixed point result is rounded towards zero)
+ * \return Non zero value if value is NaN, infinity or doesn't fit fixed point cell
+*/
+int native_set_real(NativeCall *call, size_t index, double value);
+
+
+/**
+ * \brief Checks RAM range
+ * \param [in] call Call
+ * \param [in] address First cell
+ * \param [in] count Cell count
+ * \return Pointer to the first cell or nullptr if range is out of RAM
+*/
+void *native_ram(const NativeCall *call, long long address, long long count);
+
+
+int native_register(const char *name, native_t function, size_t args, size_t results) {
+    ASSERT(name && function, "Invalid native function!");
+    ASSERT(args <= NATIVE_VALUES && results <= NATIVE_VALUES, "Too many arguments or results of native function!");
+
+    arg_t hash = native_hash(name, strlen(name));
+
+    for(size_t i = 0; i < NATIVE_FUNCTIONS; i++) {
+        NativeFunction *entry = NATIVES + (((size_t)(unsigned int) hash + i) & (NATIVE_FUNCTIONS - 1));
+
+        if (entry -> function) {
+            if (entry -> hash == hash) {
+                printf("Native function %s is already registered!\n", name);
+                return 1;
+            }
+
+            continue;
+        }
+
+        entry -> name = name;
+        entry -> hash = hash;
+        entry -> function = function;
+        entry -> args = args;
+        entry -> results = results;
+
+        return 0;
+    }
+
+    printf("Too many native functions!\n");
+    return 1;
+}
+
+
+const NativeFunction *native_find(arg_t hash) {
+    for(size_t i = 0; i < NATIVE_FUNCTIONS; i++) {
+        const NativeFunction *entry = NATIVES + (((size_t)(unsigned int) hash + i) & (NATIVE_FUNCTIONS - 1));
+
+        if (!entry -> function) return nullptr;
+
+        if (entry -> hash == hash) return entry;
+    }
+
+    return nullptr;
+}
+
+
+long long native_int(const NativeCall *call, size_t index) {
+    switch (call -> cell) {
+        case CELL_FIXED32: return fixed_to_int(((const int *) call -> args)[index], call -> fixed);
+        case CELL_FIXED64: return fixed_to_int64(((const long long *) call -> args)[index], call -> fixed);
+        default:           return (long long) ((const double *) call -> args)[index];
+    }
+}
+
+
+double native_real(const NativeCall *call, size_t index) {
+    switch (call -> cell) {
+        case CELL_FIXED32: return (double) ((const int *) call -> args)[index] / call -> fixed -> precision;
+        case CELL_FIXED64: return (double) ((const long long *) call -> args)[index] / call -> fixed -> precision;
+        default:           return ((const double *) call -> args)[index];
+    }
+}
+
+
+void native_set_int(NativeCall *call, size_t index, long long value) {
+    switch (call -> cell) {
+        case CELL_FIXED32: ((int *) call -> results)[index] = fixed_from_int(value, call -> fixed); break;
+        case CELL_FIXED64: ((long long *) call -> results)[index] = fixed_from_int64(value, call -> fixed); break;
+        default:           ((double *) call -> results)[index] = (double) value; break;
+    }
+}
+
+
+int native_set_real(NativeCall *call, size_t index, double value) {
+    if (call -> cell == CELL_DOUBLE) {
+        ((double *) call -> results)[index] = value;
+        return 0;
+    }
+
+    double units = value * call -> fixed -> precision;
+    double limit = (call -> cell == CELL_FIXED32) ? 2147483648.0 : 9223372036854775808.0;
+
+    // Conversion of NaN or number out of range is undefined, NaN fails both comparisons
+    ASSERT(units > -limit - 1 && units < limit, "Native result doesn't fit cell!");
+
+    if (call -> cell == CELL_FIXED32)
+        ((int *) call -> results)[index] = (int) units;
+    else
+        ((long long *) call -> results)[index] = (long long) units;
+
+    return 0;
+}
+
+
+void *native_ram(const NativeCall *call, long long address, long long count) {
+    if (address < 0 || count < 0 || (size_t) address > call -> ram_size || (size_t) count > call -> ram_size - (size_t) address)
+        return nullptr;
+
+    return (char *) call -> ram + (size_t) address * CELL_SIZE[call -> cell];
+}
+
+
+/// Compares cells for qsort()
+template <typename cell_t>
+static int native_compare(const void *a, const void *b) {
+    cell_t x = *(const cell_t *) a, y = *(const cell_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+
+/// sort (address, count): sorts RAM range in ascending order
+static int native_sort(NativeCall *call) {
+    long long count = native_int(call, 1);
+    void *ram = native_ram(call, native_int(call, 0), count);
+
+    ASSERT(ram, "Sort range is out of RAM!");
+
+    switch (call -> cell) {
+        case CELL_FIXED32: qsort(ram, (size_t) count, sizeof(int), native_compare<int>); break;
+        case CELL_FIXED64: qsort(ram, (size_t) count, sizeof(long long), native_compare<long long>); break;
+        default:           qsort(ram, (size_t) count, sizeof(double), native_compare<double>); break;
+    }
+
+    return 0;
+}
+
+
+/// memcpy (destination, source, count): copies RAM range (ranges can overlap)
+static int native_memcpy(NativeCall *call) {
+    long long count = native_int(call, 2);
+    void *dst = native_ram(call, native_int(call, 0), count);
+    void *src = native_ram(call, native_int(call, 1), count);
+
+    ASSERT(dst && src, "Copy range is out of RAM!");
+
+    memmove(dst, src, (size_t) count * CELL_SIZE[call -> cell]);
+
+    return 0;
+}
+
+
+/// hash (address, count): FNV-1a hash of RAM range as non negative integer that fits cell
+static int native_fnv(NativeCall *call) {
+    long long count = native_int(call, 1);
+    const unsigned char *ram = (const unsigned char *) native_ram(call, native_int(call, 0), count);
+
+    ASSERT(ram, "Hash range is out of RAM!");
+
+    unsigned int hash = 2166136261u;
+
+    for(size_t i = 0; i < (size_t) count * CELL_SIZE[call -> cell]; i++)
+        hash = (hash ^ ram[i]) * 16777619u;
+
+    // Integer part of 32 bit fixed point number is smaller than 32 bits
+    if (call -> cell == CELL_FIXED32)
+        hash %= (unsigned int)(2147483647 / call -> fixed -> precision) + 1;
+
+    native_set_int(call, 0, hash);
+
+    return 0;
+}
+
+
+static int native_sin(NativeCall *call)   { return native_set_real(call, 0, sin(native_real(call, 0))); }
+static int native_cos(NativeCall *call)   { return native_set_real(call, 0, cos(native_real(call, 0))); }
+static int native_exp(NativeCall *call)   { return native_set_real(call, 0, exp(native_real(call, 0))); }
+static int native_log(NativeCall *call)   { return native_set_real(call, 0, log(native_real(call, 0))); }
+static int native_atan2(NativeCall *call) { return native_set_real(call, 0, atan2(native_real(call, 0), native_real(call, 1))); }
+static int native_pow(NativeCall *call)   { return native_set_real(call, 0, pow(native_real(call, 0), native_real(call, 1))); }
+
+
+/**
+ * \brief Registers built-in functions
+ * \return Non zero value means error
+*/
+int native_builtin() {
+    return native_register("sort", native_sort, 2, 0) ||
+           native_register("memcpy", native_memcpy, 3, 0) ||
+           native_register("hash", native_fnv, 2, 1) ||
+           native_register("sin", native_sin, 1, 1) ||
+           native_register("cos", native_cos, 1, 1) ||
+           native_register("exp", native_exp, 1, 1) ||
+           native_register("log", native_log, 1, 1) ||
+           native_register("atan2", native_atan2, 2, 1) ||
+           native_register("pow", native_pow, 2, 1);
+}
+
+
+/**
+ * \brief Checks that every NCALL calls registered function
+ * \param [in] code Process code
+ * \param [in] count Code size
+ * \return Non zero value means error
+*/
+template <typename cell_t>
+int native_check(const cmd_t *code, size_t count) {
+    for(size_t offset = 0; offset < count;) {
+        const cmd_t *args = code + offset;
+        cmd_t cmd = *args++;
+        unsigned int command = cmd & CMD_MASK;
+
+        if (command == CMD_EXT)
+            command += *args++;
+
+        size_t next = (size_t)(args - code) + command_args_size<cell_t>(command, (cmd_t)(cmd & ~CMD_MASK));
+
+        if (command == CMD_NCALL && next <= count && !native_find(*((const arg_t *)(args)))) {
+            printf("Unknown native function %08X in operation %zu!\n", (unsigned int) *((const arg_t *)(args)), offset);
+            return 1;
+        }
+
+        offset = next;
+    }
+
+    return 0;
+}
+
+
+/**
+ * \brief Pops arguments of native function, calls it and pushes its results
+ * \param process Process that executes NCALL
+ * \param [in] hash Name hash
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int native_call(Process<Policy> *process, arg_t hash) {
+    typedef typename Policy::cell_t cell_t;
+
+    const NativeFunction *function = native_find(hash);
+
+    ASSERT(function, "Unknown native function!");
+
+    Stack<cell_t> *stack = &(process -> value_stack);
+
+    ASSERT((size_t) stack -> size >= function -> args, "Not enough arguments for native function!");
+
+    cell_t args[NATIVE_VALUES] = {}, results[NATIVE_VALUES] = {};
+
+    for(size_t i = function -> args; i > 0; i--)
+        ASSERT(!stack_pop(stack, args + i - 1), "Stack pop error!");
+
+    NativeCall call = {};
+
+    call.cell = Policy::CELL;
+    call.fixed = &(process -> fixed);
+    call.ram = process -> ram;
+    call.ram_size = process -> ram_size;
+    call.args = args;
+    call.results = results;
+
+    if (function -> function(&call)) {
+        printf("Native function %s failed!\n", function -> name);
+        return 1;
+    }
+
+    for(size_t i = 0; i < function -> results; i++)
+        ASSERT(!stack_push(stack, results[i]), "Stack push error!");
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * \file
+ * \brief Cell types and arithmetic the processor core is specialized with
+ * \note Every policy has the same static interface, so execute() compiles to a separate loop for each one
+*/
+
+
+/// Bulk operations that don't depend on number format
+template <typename cell_t>
+struct ScalarVector {
+    static void vfill(cell_t *dst, cell_t value, size_t count) {
+        for(size_t i = 0; i < count; i++) dst[i] = value;
+    }
+
+    static void vadd(cell_t *dst, const cell_t *a, const cell_t *b, size_t count) {
+        for(size_t i = 0; i < count; i++) dst[i] = a[i] + b[i];
+    }
+
+    static void vsub(cell_t *dst, const cell_t *a, const cell_t *b, size_t count) {
+        for(size_t i = 0; i < count; i++) dst[i] = a[i] - b[i];
+    }
+
+    static cell_t vsum(const cell_t *src, size_t count) {
+        cell_t sum = 0;
+        for(size_t i = 0; i < count; i++) sum += src[i];
+        return sum;
+    }
+
+    static cell_t vmin(const cell_t *src, size_t count) {
+        cell_t min = src[0];
+        for(size_t i = 1; i < count; i++) if (src[i] < min) min = src[i];
+        return min;
+    }
+
+    static cell_t vmax(const cell_t *src, size_t count) {
+        cell_t max = src[0];
+        for(size_t i = 1; i < count; i++) if (src[i] > max) max = src[i];
+        return max;
+    }
+};
+
+
+/// Atomic operations on RAM cells shared by guest threads (generic builtins work for every cell type)
+template <typename cell_t>
+struct AtomicCells {
+    static cell_t atomic_add(cell_t *ptr, cell_t value) {
+        cell_t old = 0;
+        __atomic_load(ptr, &old, __ATOMIC_SEQ_CST);
+
+        cell_t sum = old + value;
+
+        while (!__atomic_compare_exchange(ptr, &old, &sum, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            sum = old + value;
+
+        return old;
+    }
+
+    static cell_t atomic_exchange(cell_t *ptr, cell_t value) {
+        cell_t old = 0;
+        __atomic_exchange(ptr, &value, &old, __ATOMIC_SEQ_CST);
+        return old;
+    }
+
+    static cell_t atomic_cas(cell_t *ptr, cell_t expected, cell_t desired) {
+        __atomic_compare_exchange(ptr, &expected, &desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+        return expected;
+    }
+};
+
+
+/// 32 bit fixed point cells (bulk operations use SIMD kernels)
+struct Fixed32Policy : AtomicCells<int> {
+    typedef int cell_t; ///< Cell type
+
+    static const int CELL = CELL_FIXED32; ///< Cell type in binary header
+
+    static cell_t mul(cell_t a, cell_t b, const Fixed *fixed)   { return fixed_mul(a, b, fixed); }
+    static cell_t div(cell_t a, cell_t b, const Fixed *fixed)   { return fixed_div(a, b, fixed); }
+    static cell_t sqrt(cell_t a, const Fixed *fixed)            { return fixed_sqrt(a, fixed); }
+    static int equal(cell_t a, cell_t b)                        { return a == b; }
+
+    static long long to_int(cell_t a, const Fixed *fixed)       { return fixed_to_int(a, fixed); }
+    static cell_t from_int(long long a, const Fixed *fixed)     { return fixed_from_int(a, fixed); }
+    static int to_units(cell_t a, const Fixed *fixed)           { return a; }
+    static void print(FILE *stream, cell_t a)                   { fprintf(stream, "%i ", a); }
+
+    static void vfill(cell_t *dst, cell_t value, size_t count) {
+        get_vector_kernels() -> fill(dst, value, count);
+    }
+
+    static void vadd(cell_t *dst, const cell_t *a, const cell_t *b, size_t count) {
+        get_vector_kernels() -> add(dst, a, b, count);
+    }
+
+    static void vsub(cell_t *dst, const cell_t *a, const cell_t *b, size_t count) {
+        get_vector_kernels() -> sub(dst, a, b, count);
+    }
+
+    static void vmul(cell_t *dst, const cell_t *a, const cell_t *b, size_t count, const Fixed *fixed) {
+        get_vector_kernels() -> mul(dst, a, b, count, fixed -> precision);
+    }
+
+    static cell_t vdot(const cell_t *a, const cell_t *b, size_t count, const Fixed *fixed) {
+        return fixed_reduce(get_vector_kernels() -> dot(a, b, count), fixed);
+    }
+
+    static cell_t vsum(const cell_t *src, size_t count) { return (int) get_vector_kernels() -> sum(src, count); }
+    static cell_t vmin(const cell_t *src, size_t count) { return get_vector_kernels() -> min(src, count); }
+    static cell_t vmax(const cell_t *src, size_t count) { return get_vector_kernels() -> max(src, count); }
+};
+
+
+/// 64 bit fixed point cells (intermediate results are 128 bit)
+struct Fixed64Policy : ScalarVector<long long>, AtomicCells<long long> {
+    typedef long long cell_t; ///< Cell type
+
+    static const int CELL = CELL_FIXED64; ///< Cell type in binary header
+
+    static cell_t mul(cell_t a, cell_t b, const Fixed *fixed)   { return fixed_mul64(a, b, fixed); }
+    static cell_t div(cell_t a, cell_t b, const Fixed *fixed)   { return fixed_div64(a, b, fixed); }
+    static cell_t sqrt(cell_t a, const Fixed *fixed)            { return fixed_sqrt64(a, fixed); }
+    static int equal(cell_t a, cell_t b)                        { return a == b; }
+
+    static long long to_int(cell_t a, const Fixed *fixed)       { return fixed_to_int64(a, fixed); }
+    static cell_t from_int(long long a, const Fixed *fixed)     { return fixed_from_int64(a, fixed); }
+    static int to_units(cell_t a, const Fixed *fixed)           { return (int) a; }
+    static void print(FILE *stream, cell_t a)                   { fprintf(stream, "%lli ", a); }
+
+    static void vmul(cell_t *dst, const cell_t *a, const cell_t *b, size_t count, const Fixed *fixed) {
+        for(size_t i = 0; i < count; i++) dst[i] = fixed_mul64(a[i], b[i], fixed);
+    }
+
+    static cell_t vdot(const cell_t *a, const cell_t *b, size_t count, const Fixed *fixed) {
+        __int128 sum = 0;
+        for(size_t i = 0; i < count; i++) sum += (__int128) a[i] * (__int128) b[i];
+        return fixed_reduce64(sum, fixed);
+    }
+};
+
+
+/// IEEE 754 double cells (precision from header is used only to show cells on screen)
+struct DoublePolicy : ScalarVector<double>, AtomicCells<double> {
+    typedef double cell_t; ///< Cell type
+
+    static const int CELL = CELL_DOUBLE; ///< Cell type in binary header
+
+    static cell_t mul(cell_t a, cell_t b, const Fixed *fixed)   { return a * b; }
+    static cell_t div(cell_t a, cell_t b, const Fixed *fixed)   { return a / b; }
+    static cell_t sqrt(cell_t a, const Fixed *fixed)            { return ::sqrt(a); }
+    static int equal(cell_t a, cell_t b)                        { return !(a < b) && !(a > b); }
+
+    static long long to_int(cell_t a, const Fixed *fixed)       { return (long long) a; }
+    static cell_t from_int(long long a, const Fixed *fixed)     { return (double) a; }
+    static int to_units(cell_t a, const Fixed *fixed)           { return (int)(a * fixed -> precision); }
+    static void print(FILE *stream, cell_t a)                   { fprintf(stream, "%g ", a); }
+
+    static void vmul(cell_t *dst, const cell_t *a, const cell_t *b, size_t count, const Fixed *fixed) {
+        for(size_t i = 0; i < count; i++) dst[i] = a[i] * b[i];
+    }
+
+    static cell_t vdot(const cell_t *a, const cell_t *b, size_t count, const Fixed *fixed) {
+        double sum = 0;
+        for(size_t i = 0; i < count; i++) sum += a[i] * b[i];
+        return sum;
+    }
+};
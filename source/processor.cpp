@@ -6,74 +6,368 @@
     #define O_BINARY 0
 
     #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <sys/wait.h>
 #else
     #error "Your system case is not defined!"
 #endif
 
 #include <fcntl.h>
 #include <stdlib.h>
-#include <math.h>
 #include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/stat.h>
 #include "libs/stack.hpp"
 #include "libs/parser.hpp"
+#include "libs/trace.hpp"
+#include "libs/memory.hpp"
+#include "libs/vector.hpp"
+#include "libs/screen.hpp"
+#include "libs/frames.hpp"
+#include "libs/fixed.hpp"
+#include "libs/iochan.hpp"
+#include "libs/thread.hpp"
+#include "libs/msgchan.hpp"
 #include "console/cpu_func_list.hpp"
 #include "command.hpp"
+#include "policy.hpp"
+#include "decode.hpp"
 #include "assert.hpp"
 
 
 const unsigned int SCREEN_WIDTH  = 50;
 const unsigned int SCREEN_HEIGHT = 20;
-const unsigned int SCREEN_SIZE = SCREEN_HEIGHT * SCREEN_WIDTH;
 
 const unsigned int REGISTER_SIZE = 4;
-const unsigned int RAM_SIZE = 1200;
 
+const size_t MAX_THREADS = 64;
 
-/// Contains information about process to execute
+const size_t GREEN_QUANTUM = 10000;
+
+const size_t PURE_CACHE = 4096;
+
+const size_t PURE_DEPTH = 64;
+
+
+/// RAM with registers kept between runs, so the next process doesn't reserve new one
+typedef struct {
+    void *ram = nullptr; ///< Zeroed RAM of finished process (nullptr if arena is empty)
+    size_t size = 0; ///< RAM size in cells
+    size_t cell = 0; ///< Cell size in bytes (guard pages reserve range by cell count, so size in bytes isn't enough)
+} Arena;
+
+
+/// Program loaded from binary file and devices it works with
 typedef struct {
     cmd_t *code = nullptr; ///< Operation code 
     size_t count = 0; ///< Operation count
 
-    cmd_t *ip = 0; ///< Instruction pointer
+    size_t ram_size = RAM_SIZE; ///< RAM size in cells
+    int cell = CELL_FIXED32; ///< One of CELL_TYPE
+    int regvm = 0; ///< Compile code to register code at load time and execute it
+    int blocks = 0; ///< Split code into basic blocks at load time and dispatch them at once
+    int jit = 0; ///< Compile hot loops of register code into native code
+
+    size_t workers = 1; ///< Threads that execute PARFOR
+    size_t chunk = 0; ///< Indexes taken by PARFOR worker at once, 0 splits range into equal parts
+
+    size_t green_threads = 1; ///< Threads that execute green processes
+    size_t quantum = GREEN_QUANTUM; ///< Instructions executed by green process before switch
+    size_t green_ram_size = 0; ///< Private RAM size of green process in cells (0 means shared RAM)
+
+    size_t message_capacity = MSG_CAPACITY; ///< Capacity of every message channel in cells
+
+    const void *blockcode = nullptr; ///< BlockCode built in advance by server (nullptr means that blocks are built at start)
+
+    int snapshot = -1; ///< File for SNAPSHOT (-1 if SNAPSHOT does nothing)
+    int restore = -1; ///< Snapshot to continue from (-1 starts program from the beginning)
+
+    size_t pure_size = PURE_CACHE; ///< Entries in cache of pure routine calls
+
+    size_t heap_size = 0; ///< Heap size in cells after static RAM (0 means that ALLOC is not available)
+
+    int huge = 0; ///< Ask system to back RAM with huge pages
+    Arena *arena = nullptr; ///< Arena that gives RAM to process and takes it back (nullptr means that RAM is reserved for every run)
+    int failed = 0; ///< Process or some of its threads failed during the last run_program()
+
+    Fixed fixed = {}; ///< Fixed point format of all numbers
+
+    Trace *trace = nullptr; ///< Execution trace (nullptr if tracing is off)
+
+    Screen *screen = nullptr; ///< Screen for SHOW and CLR
+    FrameStream *frames = nullptr; ///< Frame stream for SHOW (used instead of screen if set)
+
+    IoChannel *io = nullptr; ///< Array of IO_CHANNELS channels (IN and OUT use channel 0)
+} Program;
+
+
+template <typename Policy>
+struct GuestThread;
+
+template <typename Policy>
+struct Scheduler;
+
+template <typename cell_t>
+struct PureCache;
+
+template <typename cell_t>
+struct Heap;
+
+
+/// Contains information about process to execute
+template <typename Policy>
+struct Process {
+    typedef typename Policy::cell_t cell_t; ///< Cell type
+
+    const cmd_t *code = nullptr; ///< Operation code 
+    size_t count = 0; ///< Operation count
+
+    const cmd_t *ip = 0; ///< Instruction pointer
+
+    Stack<cell_t> value_stack = {}; ///< Contains values 
+    Stack<int> call_stack = {}; ///< Function backtrace
+
+    cell_t *reg = nullptr; ///< Process REGISTER (cache line right before RAM unless it is shared)
+    cell_t *ram = nullptr; ///< Process RAM
+    Arena *arena = nullptr; ///< Arena that takes RAM back when process is freed
+
+    size_t ram_size = RAM_SIZE; ///< RAM size in cells
+    size_t ram_mask = 0; ///< RAM index mask of guard build (set by ram_mask() when RAM is reserved)
+
+    Fixed fixed = {}; ///< Fixed point format of all numbers
+
+    Trace *trace = nullptr; ///< Execution trace (nullptr if tracing is off)
+
+    Screen *screen = nullptr; ///< Screen for SHOW and CLR
+    FrameStream *frames = nullptr; ///< Frame stream for SHOW (used instead of screen if set)
+    int *cells = nullptr; ///< Screen cells converted to fixed point units (nullptr for 32 bit fixed point)
+
+    IoChannel *io = nullptr; ///< Array of IO_CHANNELS channels (IN and OUT use channel 0)
+
+    GuestThread<Policy> *threads = nullptr; ///< Array of MAX_THREADS guest threads shared by all threads of program
+
+    ThreadPool *pool = nullptr; ///< PARFOR workers shared by all threads of program (nullptr if PARFOR is executed by one thread)
+    size_t chunk = 0; ///< Indexes taken by PARFOR worker at once, 0 splits range into equal parts
+
+    int body = 0; ///< Process executes PARFOR body, return to the end of code finishes it
+
+    Scheduler<Policy> *scheduler = nullptr; ///< Scheduler of green processes shared by all threads of program
+    size_t quantum = 0; ///< Instructions executed by green process before switch (0 for other processes)
+    int yielded = 0; ///< Green process gave its thread to others and has to be continued from ip
+
+    MessageChannel *messages = nullptr; ///< Array of MSG_CHANNELS message channels shared by all processes of program
+
+    int snapshot = -1; ///< File for SNAPSHOT (-1 if SNAPSHOT does nothing)
+
+    int root = 0; ///< Process is started by run_program() (only it can FORK)
+    int forked = 0; ///< Process is child created by FORK and exits at the end of run_program()
+    int failed = 0; ///< Process failed (set by process_failed())
+    int *children = nullptr; ///< Children created by FORK (system process identifiers)
+    size_t forks = 0; ///< Children count
+
+    PureCache<cell_t> *pure = nullptr; ///< Cache of pure routine calls shared by all threads of program (nullptr if CALL doesn't check PURE)
+    size_t pure_depth = 0; ///< Pure routines that are executed by nested execute() at once
+
+    Heap<cell_t> *heap = nullptr; ///< Heap of ALLOC and FREE shared by all threads of program (nullptr if heap is off)
+};
+
+
+/// Guest thread states
+typedef enum {
+    THREAD_FREE     = 0, ///< Slot can be used by SPAWN
+    THREAD_STARTING = 1, ///< Slot is taken by SPAWN that has not started thread yet
+    THREAD_RUNNING  = 2, ///< Thread is started and not joined yet
+    THREAD_JOINING  = 3, ///< Thread is joined by JOIN or join_threads() right now
+    THREAD_DONE     = 4, ///< Thread is stopped by join_threads(), its error waits for JOIN
+} THREAD_STATES;
+
+
+/// Guest thread started by SPAWN
+template <typename Policy>
+struct GuestThread {
+    Process<Policy> process = {};   ///< Own stacks and registers, code, RAM and devices are shared
+    Thread thread = {};             ///< OS thread
+    int state = THREAD_FREE;        ///< One of THREAD_STATES
+    int error = 0;                  ///< Result of execute()
+};
+
+
+/// Cooperative scheduler of green processes started by GO
+template <typename Policy>
+struct Scheduler {
+    Monitor monitor = {};                   ///< Protects scheduler state
+    Process<Policy> **queue = nullptr;      ///< Ring buffer of ready green processes
+    size_t capacity = 0;                    ///< Queue capacity
+    size_t head = 0;                        ///< Index of the first ready process
+    size_t size = 0;                        ///< Ready process count
+    size_t live = 0;                        ///< Started processes that have not finished yet
+    Thread *threads = nullptr;              ///< Threads that execute green processes (started by the first GO)
+    size_t count = 0;                       ///< Thread count
+    size_t quantum = GREEN_QUANTUM;         ///< Instructions executed by green process before switch
+    size_t ram_size = 0;                    ///< Private RAM size of green process in cells (0 means shared RAM)
+    int huge = 0;                           ///< Ask system to back private RAM with huge pages
+    int stop = 0;                           ///< Threads have to exit when queue is empty
+    int failed = 0;                         ///< Some green process failed
+};
+
+
+/// Shared state of PARFOR loop
+template <typename Policy>
+struct ParallelLoop {
+    typedef typename Policy::cell_t cell_t; ///< Cell type
+
+    Process<Policy> *process = nullptr; ///< Process that executes PARFOR
+    const cell_t *reg = nullptr;        ///< Registers copied into every worker
+    arg_t index = 0;                    ///< Register that receives loop index
+    arg_t target = 0;                   ///< Body offset
+    long long start = 0;                ///< First index
+    long long end = 0;                  ///< Index after the last one
+    long long next = 0;                 ///< First index of the next chunk (dynamic chunking)
+    int error = 0;                      ///< Some body failed, other workers stop
+};
+
+
+/**
+ * \brief Reads binary file
+ * \param [out] file Input file
+ * \param [in]  program Program to read in
+ * \return Non zero value means error
+*/
+int read_file(int file, Program *program);
+
+
+/**
+ * \brief Reads from file until size bytes are read or file ends (pipes and sockets return data by parts)
+ * \param [in]  file Input file
+ * \param [out] data Buffer
+ * \param [in]  size Bytes to read
+ * \return Bytes actually read
+*/
+size_t read_full(int file, void *data, size_t size);
+
+
+#ifdef AOT_SOURCE
+/**
+ * \brief Loads program translated by aot.exe from AOT_SOURCE
+ * \param [out] program Program to load in
+ * \return Non zero value means error
+*/
+int aot_load(Program *program);
+#endif
+
+
+/**
+ * \brief Runs program on processor specialized for its cell type
+ * \param [in] program Program to run
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int run_program(Program *program);
+
+
+/**
+ * \brief Reads program code and format from snapshot
+ * \param [in]  file Snapshot file (kept open for run_program())
+ * \param [out] program Program to read in (if it already has code, code must be the same)
+ * \return Non zero value means error
+*/
+int snapshot_load(int file, Program *program);
+
+
+/**
+ * \brief Checks that both descriptors are the same file (SNAPSHOT can't overwrite snapshot that is restored)
+ * \param [in] first  File
+ * \param [in] second File or -1
+ * \return Non zero value if files are the same
+*/
+int same_file(int first, int second);
+
+
+/**
+ * \brief Registers built-in native functions for NCALL
+ * \return Non zero value means error
+*/
+int native_builtin();
+
+
+#ifdef NATIVE_SOURCE
+/**
+ * \brief Registers native functions of host program with native_register() (defined in NATIVE_SOURCE)
+ * \return Non zero value means error
+*/
+int native_setup();
+#endif
+
+
+#ifdef GUARD_PAGES
+/**
+ * \brief Sets SIGSEGV handler that turns access to guard pages into segmentation fault error of process
+ * \return Non zero value means error
+*/
+int guard_install();
+#endif
 
-    Stack value_stack = {}; ///< Contains values 
-    Stack call_stack = {}; ///< Function backtrace
 
-    arg_t *reg; ///< Process REGISTER
-    arg_t *ram; ///< Process RAM
-} Process;
+/**
+ * \brief Loads binary files and executes them by requests over Unix socket until stop request
+ * \param [in] path Socket path
+ * \param [in] settings Execution settings for all programs
+ * \param [in] ram_size RAM size in cells (0 means size from binary file)
+ * \param [in] workers Threads that execute requests
+ * \param [in] screen_width Screen width for SHOW
+ * \param [in] screen_height Screen height for SHOW
+ * \return Non zero value means error
+*/
+int server_main(const char *path, const Program *settings, size_t ram_size, size_t workers, unsigned int screen_width, unsigned int screen_height);
 
 
 /**
  * \brief Allocates process memory
  * \param process Process to allocate
+ * \param [in] program Program to execute
+ * \note RAM is committed lazily, so only touched pages consume memory
  * \return Non zero value means error
 */
-int init_process(Process *process);
+template <typename Policy>
+int init_process(Process<Policy> *process, const Program *program);
 
 
 /**
- * \brief Reads binary file
- * \param [out] file Input file
- * \param [in]  process Process to read in
+ * \brief Executes process
+ * \param process Process to execute
  * \return Non zero value means error
 */
-int read_file(int file, Process *process);
+template <typename Policy>
+int execute(Process<Policy> *process);
 
 
 /**
- * \brief Executes process
+ * \brief Executes commands of process one by one (called by execute())
  * \param process Process to execute
  * \return Non zero value means error
 */
-int execute(Process *process);
+template <typename Policy>
+int execute_commands(Process<Policy> *process);
 
 
 /**
  * \brief Prints all information about process
  * \param [in] process Process to print
 */
-void print_process(Process *process);
+template <typename Policy>
+void print_process(Process<Policy> *process);
+
+
+/**
+ * \brief Prints failed process and closes message channels, so processes waiting in SEND and RECV fail too
+ * \param [in] process Failed process
+*/
+template <typename Policy>
+static void process_failed(Process<Policy> *process);
 
 
 /**
@@ -81,244 +375,1431 @@ void print_process(Process *process);
  * \param process Process to free
  * \return Non zero value means error
 */
-int free_process(Process *process);
+template <typename Policy>
+int free_process(Process<Policy> *process);
 
 
-int execute_pop(Process *process, cmd_t **ip, cmd_t cmd, arg_t arg);   ///< Executes pop command
-int show_ram(Process *process);                                        ///< Executes show command
+/**
+ * \brief Releases RAM kept by arena
+ * \param arena Arena to empty
+*/
+void arena_destructor(Arena *arena);
 
 
+template <typename Policy>
+int execute_pop(Process<Policy> *process, const cmd_t **ip, cmd_t cmd);   ///< Executes pop command
 
+template <typename Policy>
+int show_ram(Process<Policy> *process);                             ///< Executes show command
 
-int main(int argc, char *argv[]) {
-    int input = -1;
 
-    #include "console/cpu_cmd_list.hpp"
+/**
+ * \brief Starts guest thread with copy of registers and empty stacks
+ * \param process Process that executes SPAWN
+ * \param [in] reg Registers to copy
+ * \param [in] target Offset thread starts from
+ * \return Thread index or -1 on error
+*/
+template <typename Policy>
+int spawn_thread(Process<Policy> *process, const typename Policy::cell_t *reg, arg_t target);
 
-    if (parse_args(argc, argv, command_list, sizeof(command_list) / sizeof(Command)))
-        return 1;
 
-    if (input == -1)
-        return 1;
+/**
+ * \brief Waits for guest thread and frees it
+ * \param process Process that executes JOIN
+ * \param [in] index Thread index returned by spawn_thread()
+ * \return Non zero value means wrong index or failed thread
+*/
+template <typename Policy>
+int join_thread(Process<Policy> *process, long long index);
 
-    Process process = {};
 
-    init_process(&process);
+/**
+ * \brief Waits for all guest threads that are not joined yet
+ * \param process Main process
+ * \return Non zero value means that some thread failed
+*/
+template <typename Policy>
+int join_threads(Process<Policy> *process);
 
-    if (read_file(input, &process))
-        return 1;
 
-    close(input);
+/**
+ * \brief Calls body for every index from register value up to end on PARFOR workers
+ * \param process Process that executes PARFOR
+ * \param reg Registers, index register is set to the last index + 1 after loop
+ * \param [in] index Register that receives loop index
+ * \param [in] end Index after the last one
+ * \param [in] target Body offset
+ * \note Every worker has own copy of registers and stacks, RAM is shared
+ * \return Non zero value means that some body failed
+*/
+template <typename Policy>
+int parallel_for(Process<Policy> *process, typename Policy::cell_t *reg, arg_t index, typename Policy::cell_t end, arg_t target);
 
-    if (execute(&process))
-        print_process(&process);
 
-    if (free_process(&process))
-        return 1;
+/**
+ * \brief Creates scheduler of green processes, threads are started by the first GO
+ * \param [out] scheduler Scheduler to create
+ * \param [in]  program Program with scheduler settings
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int scheduler_constructor(Scheduler<Policy> *scheduler, const Program *program);
 
-    printf("Processor!\n");
 
-    return 0;
-}
+/**
+ * \brief Waits for all green processes and frees scheduler
+ * \param [in] scheduler Scheduler to free
+ * \return Non zero value means that some green process failed
+*/
+template <typename Policy>
+int scheduler_destructor(Scheduler<Policy> *scheduler);
 
 
-#define OFFSET(ip) ip - process -> code
+/**
+ * \brief Starts green process with copy of registers and empty stacks
+ * \param process Process that executes GO
+ * \param [in] reg Registers to copy
+ * \param [in] target Offset process starts from
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int green_start(Process<Policy> *process, const typename Policy::cell_t *reg, arg_t target);
 
 
-#define DEF_CMD(name, arg, action, ...)     \
-    case CMD_##name: {                      \
-        __VA_ARGS__                         \
-        break;                              \
-    }
+/**
+ * \brief Clones process into system child process, RAM and stacks are shared by both until they are changed
+ * \param process Process that executes FORK (only process started by run_program() without running threads)
+ * \return Child number starting with 1 in parent, 0 in child and -1 on error
+*/
+template <typename Policy>
+long long fork_process(Process<Policy> *process);
 
-#include "dsl.hpp"
 
-int execute(Process *process) {
-    /// SHORTCUTS ///
-    cmd_t *ip = process -> ip;
+/**
+ * \brief Waits for children created by FORK
+ * \param process Process that executes FORK
+ * \return Non zero value means that some child failed
+*/
+template <typename Policy>
+int wait_children(Process<Policy> *process);
 
-    Stack *stack = &(process -> value_stack);
-    Stack *call_stack = &(process -> call_stack);
 
-    int *reg = process -> reg;
-    int *ram = process -> ram;
 
 
-    while((size_t)(OFFSET(ip)) < process -> count) {
-        cmd_t cmd = *ip++;
-        arg_t arg = 0;
+int main(int argc, char *argv[]) {
+    int input = -1, trace_file = -1, regvm = 0, blocks = 0, jit = 0;
+    int snapshot_file = -1, restore_file = -1, huge = 0;
+    const char *server_file = nullptr;
+    size_t server_workers = 0;
+    size_t trace_size = TRACE_SIZE, ram_size = 0, workers = 0, chunk = 0;
+    size_t green_threads = 0, quantum = GREEN_QUANTUM, green_ram_size = 0, message_capacity = MSG_CAPACITY, pure_size = PURE_CACHE, heap_size = 0;
+    unsigned int screen_width = SCREEN_WIDTH, screen_height = SCREEN_HEIGHT;
+    int frames_file = -1, frames_format = FRAMES_PPM;
+    unsigned int frames_rate = 0;
+    IoChannel io[IO_CHANNELS] = {};
 
-        switch(cmd & 0x1F) {
-            #include "cmd.hpp"
+    #include "console/cpu_cmd_list.hpp"
 
-            default: {
-                printf("Unknown command %ui in operation %zu!\n", cmd, OFFSET(ip - 1));
-                return 1;
-            }
-        }
-    }
+    if (parse_args(argc, argv, command_list, sizeof(command_list) / sizeof(Command)))
+        return 1;
 
-    printf("[Warning] No hlt at end of the process!\n");
-    return 0;
-}
+    // Frames take stdout, so text output goes to stderr and doesn't break frame stream
+    if (frames_file == fileno(stdout)) {
+        fflush(stdout);
 
+        frames_file = dup(fileno(stdout));
 
-#undef DEF_CMD
+        if (frames_file == -1 || dup2(fileno(stderr), fileno(stdout)) == -1) {
+            fprintf(stderr, "Can't move text output to stderr!\n");
+            return 1;
+        }
+    }
 
+    if (native_builtin())
+        return 1;
 
-int read_file(int file, Process *process) {
-    ASSERT(file > -1, "Invalid file!");
-    ASSERT(process, "Can't work with then null pointer!");
+#ifdef NATIVE_SOURCE
+    if (native_setup())
+        return 1;
+#endif
 
-    char *sig = (char *) calloc(strlen(SIGN) + 1, sizeof(char)); 
+#ifdef GUARD_PAGES
+    if (guard_install())
+        return 1;
+#endif
 
-    size_t bytes = read(file, sig, strlen(SIGN) + 1);
+    Program program = {};
 
-    ASSERT(!strncmp(sig, SIGN, strlen(SIGN) + 1), "Signature of file doesn't match!");
+    program.regvm = regvm || jit;
+    program.jit = jit;
+    program.blocks = blocks;
 
-    free(sig);
+    program.workers = (workers) ? workers : thread_hardware_count();
+    program.chunk = chunk;
 
-    int ver = 0;
+    program.green_threads = (green_threads) ? green_threads : thread_hardware_count();
+    program.quantum = quantum;
+    program.green_ram_size = green_ram_size;
+    program.message_capacity = message_capacity;
 
-    bytes += read(file, &ver, sizeof(int));
+    program.snapshot = snapshot_file;
+    program.pure_size = pure_size;
+    program.huge = huge;
+    program.heap_size = heap_size;
 
-    ASSERT(ver == VERSION, "Version of file doesn't match!");
+#ifdef AOT_SOURCE
+    if (aot_load(&program))
+        return 1;
+#else
+    if (server_file)
+        return server_main(server_file, &program, ram_size, (server_workers) ? server_workers : thread_hardware_count(), screen_width, screen_height);
 
-    bytes += read(file, &(process -> count), sizeof(size_t));
+    if (input == -1 && restore_file == -1)
+        return 1;
 
-    process -> code = (cmd_t *) calloc(process -> count, sizeof(cmd_t));
-    
-    bytes += read(file, process -> code, (unsigned int)(process -> count * sizeof(cmd_t)));
+    if (input != -1) {
+        if (read_file(input, &program))
+            return 1;
 
-    size_t expected_bytes = strlen(SIGN) + 1 + sizeof(int) + sizeof(size_t) + process -> count * sizeof(cmd_t);
+        close(input);
+    }
+#endif
 
-    if (bytes != expected_bytes) {
-        printf("Expected bytes %zu, actualy read %zu\n", expected_bytes, bytes);
+    if (restore_file != -1 && same_file(restore_file, snapshot_file)) {
+        printf("Snapshot and restore files are the same!\n");
         return 1;
     }
 
-    process -> ip = process -> code;
-
-    return 0;
-}
+    if (restore_file != -1 && snapshot_load(restore_file, &program))
+        return 1;
 
+    if (ram_size)
+        program.ram_size = ram_size;
 
-int init_process(Process *process) {
-    ASSERT(process, "Can't work with then null pointer!");
+    if (io[0].in_file == -1 && io_open_input(io, fileno(stdin), IO_TEXT))
+        return 1;
 
-    process -> reg = (arg_t *) calloc(REGISTER_SIZE, sizeof(arg_t));
+    if (!io[0].out && io_open_output(io, fileno(stdout), IO_TEXT))
+        return 1;
 
-    ASSERT(process -> reg, "Can't allocate process reg!");
+    program.io = io;
 
-    process -> ram = (arg_t *) calloc(RAM_SIZE, sizeof(arg_t));
+    Screen screen = {};
 
-    ASSERT(process -> ram, "Can't allocate process ram!");
+    if (screen_constructor(&screen, screen_width, screen_height, fileno(stdout)))
+        return 1;
 
-    ASSERT(!stack_constructor(&process -> value_stack, 4), "Unable to construct value stack!");
-    ASSERT(!stack_constructor(&process -> call_stack, 4), "Unable to construct call stack!");
+    program.screen = &screen;
 
-    return 0;
-}
+    FrameStream frames = {};
 
+    if (frames_file != -1) {
+        if (frames_constructor(&frames, frames_file, screen_width, screen_height, frames_format, frames_rate))
+            return 1;
 
-int free_process(Process *process) {
-    ASSERT(process -> reg && process -> ram, "Process has invalid ram or register pointers!");
+        program.frames = &frames;
+    }
 
-    free(process -> ram);
-    process -> ram = nullptr;
+    Trace trace = {};
 
-    free(process -> reg);
-    process -> reg = nullptr;
+    if (trace_file != -1) {
+        if (trace_constructor(&trace, trace_size))
+            return 1;
 
-    ASSERT(!stack_destructor(&process -> value_stack), "Unable to destroy value stack!");
-    ASSERT(!stack_destructor(&process -> call_stack), "Unable to destroy call stack!");
+        trace.precision = program.fixed.precision;
 
-    return 0;
-}
+        program.trace = &trace;
 
+        trace_set_signal(&trace, trace_file);
+    }
 
-void print_process(Process *process) {
-    /*
-    printf("Operation count: %i\n", process -> count);
+    int error = 0;
 
-    for(int i = 0; i < process -> count; i++)
-        printf("%i ", process -> code[i]);
-    */
-    printf("\nRegister:\n");
+    switch (program.cell) {
+        case CELL_FIXED32: error = run_program<Fixed32Policy>(&program); break;
+        case CELL_FIXED64: error = run_program<Fixed64Policy>(&program); break;
+        case CELL_DOUBLE:  error = run_program<DoublePolicy>(&program);  break;
+        default: error = 1; break;
+    }
 
-    for(size_t i = 0; i < REGISTER_SIZE; i++)
-        printf("%i ", process -> reg[i]);
-    /*
-    printf("\nRam:\n");
+    free(program.code);
 
-    for(size_t i = 0; i < RAM_SIZE; i++)
-        printf("%i ", process -> ram[i]);
-    */
-    printf("\nValue stack:\n");
+    if (snapshot_file != -1)
+        close(snapshot_file);
 
-    stack_dump(&process -> value_stack, stack_verificator(&process -> value_stack), stdout);
-    
-    printf("Call stack:\n");
-    
-    stack_dump(&process -> call_stack, stack_verificator(&process -> call_stack), stdout);
+    if (restore_file != -1)
+        close(restore_file);
 
-    fflush(stdout);
-}
+    if (program.trace) {
+        if (trace_write(&trace, trace_file))
+            printf("Can't write trace!\n");
 
+        close(trace_file);
 
-int execute_pop(Process *process, cmd_t **ip, cmd_t cmd, arg_t arg) {
-    if (cmd & BIT_MEM) {
-        if (cmd & BIT_CONST) {
-            arg = *((arg_t *)(*ip));
-            *ip += sizeof(arg_t);
-        }
-        if (cmd & BIT_REG) {
-            arg += process -> reg[*((arg_t *)(*ip)) - 1]; // ADD REGISTER INDEX CHECK
-            *ip += sizeof(arg_t);
-        }
+        trace_destructor(&trace);
+    }
 
-        arg /= PRECISION;
+    if (program.frames) {
+        if (frames_destructor(&frames))
+            printf("Can't write frames!\n");
 
-        ASSERT_IP(arg > -1 && arg < (int) RAM_SIZE, "Segmentation fault! Wrong RAM index!", OFFSET(*ip - 1));
+        fprintf(stderr, "Frames: shown %zu, written %zu, dropped %zu\n", frames.shown, frames.written, frames.dropped);
 
-        ASSERT_IP(!stack_pop(&process -> value_stack, process -> ram + arg), "Empty stack pop!", OFFSET(*ip - 1));
+        close(frames_file);
     }
 
-    else if (cmd & BIT_CONST) {
-        int value = 0;
-        
-        ASSERT_IP(!stack_pop(&process -> value_stack, &value), "Empty stack pop!", OFFSET(*ip - 1));
-    }
-    
-    else if (cmd & BIT_REG) {
-        arg = *(arg_t *)(*ip) - 1;
-        *ip += sizeof(arg_t);
+    screen_destructor(&screen);
 
-        ASSERT_IP(arg > -1 && arg < (int) REGISTER_SIZE, "Segmentation fault! Wrong register index!", OFFSET(*ip - 1));
+    for(int i = 0; i < IO_CHANNELS; i++)
+        if (io_close(io + i))
+            printf("Can't close channel %i!\n", i);
 
-        ASSERT_IP(!stack_pop(&process -> value_stack, process -> reg + arg), "Empty stack pop!", OFFSET(*ip - 1));
-    }
+    if (error)
+        return 1;
+
+    printf("Processor!\n");
 
     return 0;
 }
 
 
-int show_ram(Process *process) {
-    ASSERT(RAM_SIZE >= SCREEN_SIZE, "Ram size is less then screen size!");
+#define OFFSET(ip) ip - process -> code
 
-    putchar(process -> ram[0]);
 
-    for(unsigned int i = 1; i < SCREEN_SIZE; i++) {
-        if (i % SCREEN_WIDTH == 0)
-            putchar('\n');
+#define DEF_CMD(name, arg, action, ...)     \
+    case CMD_##name: {                      \
+        __VA_ARGS__                         \
+        break;                              \
+    }
+
+#include "dsl.hpp"
+#include "heap.hpp"
+#include "snapshot.hpp"
+#include "pure.hpp"
+#include "natives.hpp"
+#include "guard.hpp"
+
+#ifdef NATIVE_SOURCE
+#include NATIVE_SOURCE
+#endif
+
+template <typename Policy>
+int execute(Process<Policy> *process) {
+    return guard_run(process, [process]() { return execute_commands(process); });
+}
+
+
+template <typename Policy>
+int execute_commands(Process<Policy> *process) {
+    typedef typename Policy::cell_t cell_t;
+
+    /// SHORTCUTS ///
+    const cmd_t *ip = process -> ip;
+
+    Stack<cell_t> *stack = &(process -> value_stack);
+    Stack<int> *call_stack = &(process -> call_stack);
+
+    cell_t *reg = process -> reg;
+    cell_t *ram = process -> ram;
+
+    Trace *trace = process -> trace;
+
+    const Fixed *fixed = &(process -> fixed);
+
+    size_t budget = process -> quantum;
+
+    while((size_t)(OFFSET(ip)) < process -> count) {
+        // Green process gives its thread to others after it executes quantum instructions
+        if (process -> quantum && !budget--) {
+            process -> ip = ip;
+            process -> yielded = 1;
+            return 0;
+        }
+
+        const cmd_t *op = ip;
+        cmd_t cmd = *ip++;
+        unsigned int code = cmd & CMD_MASK;
+
+        if (code == CMD_EXT)
+            code += *ip++;
+
+        if (trace)
+            trace_record(trace, OFFSET(op), code, (cmd_t)(cmd & ~CMD_MASK), (stack -> size) ? Policy::to_units(stack -> data[stack -> size - 1], fixed) : 0);
+
+        switch(code) {
+            #include "cmd.hpp"
+
+            default: {
+                printf("Unknown command %u in operation %zu!\n", code, OFFSET(ip - 1));
+                return 1;
+            }
+        }
+    }
+
+    if (!process -> body)
+        printf("[Warning] No hlt at end of the process!\n");
+
+    return 0;
+}
+
+
+#ifndef AOT_SOURCE
+#include "blocks.hpp"
+#include "regvm.hpp"
+#include "jit.hpp"
+#include "server.hpp"
+#else
+/// Program is translated for one cell type only, other specializations reject it
+template <typename Policy>
+int aot_execute(Process<Policy> *process) {
+    printf("Program is translated for other cell type!\n");
+    return 1;
+}
+
+#include AOT_SOURCE
+
+
+int aot_load(Program *program) {
+    ASSERT(program, "Can't work with then null pointer!");
+
+    program -> count = sizeof(AOT_CODE);
+    program -> ram_size = AOT_RAM_SIZE;
+    program -> cell = AOT_CELL;
+
+    ASSERT(!fixed_constructor(&program -> fixed, AOT_PRECISION), "Invalid precision in file!");
+
+    // Process runs on AOT_CODE itself (see init_process), code is loaded only by snapshot to check it
+    program -> code = nullptr;
+
+    return 0;
+}
+#endif
+
+
+#undef DEF_CMD
+
+
+template <typename Policy>
+int run_program(Program *program) {
+    Process<Policy> process = {};
+
+    if (init_process(&process, program))
+        return 1;
+
+    process.root = 1;
+
+    if (native_check<typename Policy::cell_t>(process.code, process.count)) {
+        free_process(&process);
+        return 1;
+    }
+
+    if (program -> restore != -1) {
+        if (snapshot_restore(&process, program -> restore)) {
+            free_process(&process);
+            return 1;
+        }
+
+        // Register code starts from the beginning and keeps operation indexes in call stack
+        program -> regvm = 0;
+    }
+
+    // Register code keeps stack values in registers, so trace would record stale stack top
+    if (process.trace)
+        program -> regvm = 0;
+
+    GuestThread<Policy> *threads = (GuestThread<Policy> *) calloc(MAX_THREADS, sizeof(GuestThread<Policy>));
+
+    ASSERT(threads, "Can't allocate guest threads!");
+
+    process.threads = threads;
+
+    MessageChannel *messages = (MessageChannel *) calloc(MSG_CHANNELS, sizeof(MessageChannel));
+
+    ASSERT(messages, "Can't allocate message channels!");
+
+    for(int i = 0; i < MSG_CHANNELS; i++)
+        ASSERT(!msg_constructor(messages + i, program -> message_capacity), "Can't create message channel!");
+
+    process.messages = messages;
+
+    ThreadPool pool = {};
+
+    if (program -> workers > 1) {
+        if (pool_constructor(&pool, program -> workers - 1))
+            printf("Can't create PARFOR workers, PARFOR is executed by one thread!\n");
+        else
+            process.pool = &pool;
+    }
+
+    process.chunk = program -> chunk;
+
+    Scheduler<Policy> scheduler = {};
+
+    if (scheduler_constructor(&scheduler, program))
+        printf("Can't create scheduler, GO is not available!\n");
+    else
+        process.scheduler = &scheduler;
+
+    PureCache<typename Policy::cell_t> pure = {};
+
+    if (pure_constructor(&pure, program -> pure_size))
+        printf("Can't create pure call cache, PURE routines are called as usual!\n");
+    else
+        process.pure = &pure;
+
+    Heap<typename Policy::cell_t> heap = {};
+
+    if (program -> heap_size) {
+        if (heap_constructor(&heap, process.ram, program -> ram_size, program -> heap_size))
+            printf("Can't create heap, ALLOC is not available!\n");
+        else
+            process.heap = &heap;
+    }
+
+#ifdef AOT_SOURCE
+    if (guard_run(&process, [&process]() { return aot_execute(&process); }))
+        process_failed(&process);
+#else
+    if (program -> regvm) {
+        RegCode<typename Policy::cell_t> regcode = {};
+
+        if (regvm_compile(&process, &regcode))
+            program -> regvm = 0;
+        else {
+            fprintf(stderr, "Register code: %zu operations, %zu blocks, %zu registers\n", regcode.count, regcode.blocks, regcode.size);
+
+            Jit<Policy> jit = {};
+
+            if (program -> jit && jit_constructor(&jit, &process, &regcode))
+                program -> jit = 0;
+
+            if (guard_run(&process, [&]() { return regvm_execute(&process, &regcode, (jit.hits) ? &jit : nullptr); }))
+                process_failed(&process);
+
+            if (jit.hits)
+                fprintf(stderr, "Traces: %zu compiled, %zu aborted\n", jit.compiled, jit.aborted);
+
+            jit_destructor(&jit);
+        }
+
+        regvm_free(&regcode);
+    }
+
+    if (!program -> regvm && program -> blocks) {
+        BlockCode blockcode = {};
+        const BlockCode *ready = (const BlockCode *) program -> blockcode;
+
+        if (!ready && blocks_build(&process, &blockcode))
+            program -> blocks = 0;
+        else {
+            if (!ready) {
+                fprintf(stderr, "Basic blocks: %zu\n", blockcode.count);
+                ready = &blockcode;
+            }
+
+            if (guard_run(&process, [&]() { return blocks_execute(&process, ready); }))
+                process_failed(&process);
+        }
+
+        blocks_free(&blockcode);
+    }
+
+    if (!program -> regvm && !program -> blocks && execute(&process))
+        process_failed(&process);
+#endif
+
+    int failed = join_threads(&process);
+
+    if (process.scheduler && scheduler_destructor(&scheduler))
+        failed = 1;
+
+    if (wait_children(&process))
+        failed = 1;
+
+    if (failed)
+        printf("Some threads failed!\n");
+
+    free(threads);
+
+    for(int i = 0; i < MSG_CHANNELS; i++)
+        msg_destructor(messages + i);
+
+    free(messages);
+
+    pool_destructor(&pool);
+
+    if (pure.hits || pure.misses)
+        fprintf(stderr, "Pure calls: %zu hits, %zu misses\n", pure.hits, pure.misses);
+
+    pure_destructor(&pure);
+
+    if (heap.allocs)
+        heap_report(&heap, stderr);
+
+    heap_destructor(&heap);
+
+    int error = free_process(&process) || failed;
+
+    program -> failed = process.failed || failed;
+
+    // Child doesn't return to main(), devices and files are closed by parent
+    if (process.forked) {
+        fflush(nullptr);
+        _exit(error || process.failed);
+    }
+
+    return error;
+}
+
+
+size_t read_full(int file, void *data, size_t size) {
+    size_t done = 0;
+
+    while (done < size) {
+        ssize_t bytes = read(file, (char *) data + done, size - done);
+
+        if (bytes <= 0) break;
+
+        done += (size_t) bytes;
+    }
+
+    return done;
+}
+
+
+int read_file(int file, Program *program) {
+    ASSERT(file > -1, "Invalid file!");
+    ASSERT(program, "Can't work with then null pointer!");
+
+    char *sig = (char *) calloc(strlen(SIGN) + 1, sizeof(char)); 
+
+    size_t bytes = read_full(file, sig, strlen(SIGN) + 1);
+
+    ASSERT(!strncmp(sig, SIGN, strlen(SIGN) + 1), "Signature of file doesn't match!");
+
+    free(sig);
+
+    int ver = 0;
+
+    bytes += read_full(file, &ver, sizeof(int));
+
+    ASSERT(ver == VERSION, "Version of file doesn't match!");
+
+    bytes += read_full(file, &(program -> count), sizeof(size_t));
+
+    bytes += read_full(file, &(program -> ram_size), sizeof(size_t));
+
+    int precision = 0;
+
+    bytes += read_full(file, &precision, sizeof(int));
+
+    ASSERT(!fixed_constructor(&program -> fixed, precision), "Invalid precision in file!");
+
+    bytes += read_full(file, &(program -> cell), sizeof(int));
+
+    ASSERT(program -> cell >= CELL_FIXED32 && program -> cell <= CELL_DOUBLE, "Invalid cell type in file!");
+
+    program -> code = (cmd_t *) calloc(program -> count, sizeof(cmd_t));
+    
+    bytes += read_full(file, program -> code, program -> count * sizeof(cmd_t));
+
+    size_t expected_bytes = strlen(SIGN) + 1 + 3 * sizeof(int) + 2 * sizeof(size_t) + program -> count * sizeof(cmd_t);
+
+    if (bytes != expected_bytes) {
+        printf("Expected bytes %zu, actualy read %zu\n", expected_bytes, bytes);
+        return 1;
+    }
+
+    return 0;
+}
+
+
+template <typename Policy>
+int init_process(Process<Policy> *process, const Program *program) {
+    typedef typename Policy::cell_t cell_t;
+
+    ASSERT(process && program, "Can't work with then null pointer!");
+
+#ifdef AOT_SOURCE
+    ASSERT(!program -> code || (program -> count == sizeof(AOT_CODE) && program -> cell == AOT_CELL &&
+           !memcmp(program -> code, AOT_CODE, sizeof(AOT_CODE))), "Snapshot is made by other program!");
+
+    // Translated code is constant, so compiler folds arguments that handlers read from it
+    process -> code = AOT_CODE;
+#else
+    process -> code = program -> code;
+#endif
+    process -> count = program -> count;
+    process -> ip = process -> code;
+
+    process -> ram_size = program -> ram_size + program -> heap_size;
+    process -> fixed = program -> fixed;
+
+    process -> trace = program -> trace;
+    process -> screen = program -> screen;
+    process -> frames = program -> frames;
+    process -> io = program -> io;
+
+    process -> snapshot = program -> snapshot;
+
+    ASSERT(process -> ram_size, "Process ram size is zero!");
+
+    // Snapshot maps file over RAM, so such RAM isn't zeroed by reset and doesn't go to arena
+    Arena *arena = (program -> restore == -1) ? program -> arena : nullptr;
+
+    if (arena && arena -> ram && arena -> size == process -> ram_size && arena -> cell == sizeof(cell_t)) {
+        process -> ram = (cell_t *) arena -> ram;
+        arena -> ram = nullptr;
+    }
+    else
+        process -> ram = ram_map<cell_t>(process -> ram_size, program -> huge);
+
+    ASSERT(process -> ram, "Can't allocate process ram!");
+
+    process -> ram_mask = ram_mask(process -> ram_size);
+    process -> reg = ram_registers(process -> ram);
+    process -> arena = arena;
+
+    ASSERT(!stack_constructor(&process -> value_stack, 4), "Unable to construct value stack!");
+    ASSERT(!stack_constructor(&process -> call_stack, 4), "Unable to construct call stack!");
+
+    return 0;
+}
+
+
+template <typename Policy>
+int free_process(Process<Policy> *process) {
+    ASSERT(process -> reg && process -> ram, "Process has invalid ram or register pointers!");
+
+    Arena *arena = process -> arena;
+
+    // Reset doesn't depend on RAM size, so the next run gets zeroed RAM almost for free
+    if (arena && !ram_reset(process -> ram, process -> ram_size)) {
+        arena_destructor(arena);
+
+        arena -> ram = process -> ram;
+        arena -> size = process -> ram_size;
+        arena -> cell = sizeof(*process -> ram);
+    }
+    else
+        ram_unmap(process -> ram, process -> ram_size);
+
+    process -> ram = nullptr;
+    process -> reg = nullptr;
+
+    free(process -> cells);
+    process -> cells = nullptr;
+
+    ASSERT(!stack_destructor(&process -> value_stack), "Unable to destroy value stack!");
+    ASSERT(!stack_destructor(&process -> call_stack), "Unable to destroy call stack!");
+
+    return 0;
+}
+
+
+void arena_destructor(Arena *arena) {
+    if (arena -> ram)
+        arena_unmap(arena -> ram, arena -> size, arena -> cell);
+
+    *arena = {};
+}
+
+
+template <typename Policy>
+void print_process(Process<Policy> *process) {
+    /*
+    printf("Operation count: %i\n", process -> count);
+
+    for(int i = 0; i < process -> count; i++)
+        printf("%i ", process -> code[i]);
+    */
+    printf("\nRegister:\n");
+
+    for(size_t i = 0; i < REGISTER_SIZE; i++)
+        Policy::print(stdout, process -> reg[i]);
+    /*
+    printf("\nRam:\n");
+
+    for(size_t i = 0; i < process -> ram_size; i++)
+        printf("%i ", process -> ram[i]);
+    */
+    printf("\nValue stack:\n");
+
+    stack_dump(&process -> value_stack, stack_verificator(&process -> value_stack), stdout);
+    
+    printf("Call stack:\n");
+    
+    stack_dump(&process -> call_stack, stack_verificator(&process -> call_stack), stdout);
+
+    fflush(stdout);
+}
+
+
+template <typename Policy>
+static void process_failed(Process<Policy> *process) {
+    print_process(process);
+
+    process -> failed = 1;
+
+    for(int i = 0; process -> messages && i < MSG_CHANNELS; i++)
+        msg_close(process -> messages + i);
+}
+
+
+template <typename Policy>
+int execute_pop(Process<Policy> *process, const cmd_t **ip, cmd_t cmd) {
+    typedef typename Policy::cell_t cell_t;
+
+    if (cmd & BIT_MEM) {
+        cell_t arg = 0;
+
+        if (cmd & BIT_CONST) {
+            arg = *((const cell_t *)(*ip));
+            *ip += sizeof(cell_t);
+        }
+        if (cmd & BIT_REG) {
+            arg += process -> reg[*((const arg_t *)(*ip))];
+            *ip += sizeof(arg_t);
+        }
+
+        long long index = Policy::to_int(arg, &process -> fixed);
+
+        RAM_INDEX_(index, OFFSET(*ip - 1));
+
+        cell_t value = 0;
+
+        ASSERT_IP(!stack_pop(&process -> value_stack, &value), "Empty stack pop!", OFFSET(*ip - 1));
+
+        process -> ram[index] = value;
+    }
+
+    else if (cmd & BIT_CONST) {
+        cell_t value = 0;
+        
+        ASSERT_IP(!stack_pop(&process -> value_stack, &value), "Empty stack pop!", OFFSET(*ip - 1));
+    }
+    
+    else if (cmd & BIT_REG) {
+        arg_t index = *(const arg_t *)(*ip);
+        *ip += sizeof(arg_t);
 
-        putchar(process -> ram[i]);
+        ASSERT_IP(index > -1 && index < (int) REGISTER_SIZE, "Segmentation fault! Wrong register index!", OFFSET(*ip - 1));
+
+        ASSERT_IP(!stack_pop(&process -> value_stack, process -> reg + index), "Empty stack pop!", OFFSET(*ip - 1));
     }
 
-    putchar('\n');
+    return 0;
+}
+
+
+template <typename Policy>
+static void guest_main(void *arg) {
+    GuestThread<Policy> *guest = (GuestThread<Policy> *) arg;
+
+    guest -> error = execute(&guest -> process);
+
+    if (guest -> error)
+        process_failed(&guest -> process);
+
+    heap_flush(guest -> process.heap);
+}
+
+
+/**
+ * \brief Frees guest thread process and gives its slot to SPAWN
+ * \param [in] guest Thread that is stopped or was not started
+*/
+template <typename Policy>
+static void guest_free(GuestThread<Policy> *guest) {
+    free(guest -> process.reg);
+    free(guest -> process.cells);
+
+    stack_destructor(&guest -> process.value_stack);
+    stack_destructor(&guest -> process.call_stack);
+
+    guest -> process = {};
+
+    __atomic_store_n(&guest -> state, THREAD_FREE, __ATOMIC_SEQ_CST);
+}
+
+
+template <typename Policy>
+int spawn_thread(Process<Policy> *process, const typename Policy::cell_t *reg, arg_t target) {
+    typedef typename Policy::cell_t cell_t;
+
+    if (target < 0 || (size_t) target >= process -> count) return -1;
+
+    GuestThread<Policy> *guest = nullptr;
+
+    for(size_t i = 0; i < MAX_THREADS && !guest; i++) {
+        int state = THREAD_FREE;
+
+        if (__atomic_compare_exchange_n(&process -> threads[i].state, &state, THREAD_STARTING, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+            guest = process -> threads + i;
+    }
+
+    if (!guest) return -1;
+
+    Process<Policy> *thread = &guest -> process;
+
+    *thread = *process;
+
+    thread -> ip = process -> code + target;
+    thread -> trace = nullptr;
+    thread -> cells = nullptr;
+    thread -> quantum = 0;
+    thread -> root = 0;
+
+    thread -> value_stack = {};
+    thread -> call_stack = {};
+
+    thread -> reg = (cell_t *) calloc(REGISTER_SIZE, sizeof(cell_t));
+
+    if (!thread -> reg || stack_constructor(&thread -> value_stack, 4) || stack_constructor(&thread -> call_stack, 4)) {
+        guest_free(guest);
+        return -1;
+    }
+
+    memcpy(thread -> reg, reg, REGISTER_SIZE * sizeof(cell_t));
+
+    guest -> error = 0;
+
+    if (thread_start(&guest -> thread, &guest_main<Policy>, guest)) {
+        guest_free(guest);
+        return -1;
+    }
+
+    __atomic_store_n(&guest -> state, THREAD_RUNNING, __ATOMIC_SEQ_CST);
+
+    return (int)(guest - process -> threads);
+}
+
+
+/**
+ * \brief Waits for running guest thread (its slot becomes THREAD_DONE and keeps its error)
+ * \param [in] guest Guest thread
+ * \return Non zero value if thread was joined by this call
+*/
+template <typename Policy>
+static int guest_join(GuestThread<Policy> *guest) {
+    int state = THREAD_RUNNING;
+
+    // JOIN and join_threads() can race for one slot, only one of them joins it
+    if (!__atomic_compare_exchange_n(&guest -> state, &state, THREAD_JOINING, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) return 0;
+
+    if (thread_join(&guest -> thread))
+        guest -> error = 1;
+
+    __atomic_store_n(&guest -> state, THREAD_DONE, __ATOMIC_SEQ_CST);
+
+    return 1;
+}
+
+
+/**
+ * \brief Takes error of joined guest thread and frees its slot
+ * \param [in]  guest Guest thread
+ * \param [out] error Result of execute()
+ * \return Non zero value if slot was taken by this call
+*/
+template <typename Policy>
+static int guest_take(GuestThread<Policy> *guest, int *error) {
+    int state = THREAD_DONE;
+
+    if (!__atomic_compare_exchange_n(&guest -> state, &state, THREAD_JOINING, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) return 0;
+
+    *error = guest -> error;
+
+    guest_free(guest);
+
+    return 1;
+}
+
+
+template <typename Policy>
+int join_thread(Process<Policy> *process, long long index) {
+    if (index < 0 || (size_t) index >= MAX_THREADS) return 1;
+
+    GuestThread<Policy> *guest = process -> threads + index;
+
+    for(size_t attempt = 0;; attempt++) {
+        int error = 0;
+
+        guest_join(guest);
+
+        if (guest_take(guest, &error)) return error;
+
+        // Other thread is joining it right now
+        if (__atomic_load_n(&guest -> state, __ATOMIC_SEQ_CST) != THREAD_JOINING) return 1;
+
+        thread_backoff(attempt);
+    }
+}
+
+
+template <typename Policy>
+int join_threads(Process<Policy> *process) {
+    int error = 0, joined = 1;
+
+    // Threads can spawn threads, so slots are checked until nothing is left
+    while (joined) {
+        joined = 0;
+
+        for(size_t i = 0; i < MAX_THREADS; i++)
+            joined |= guest_join(process -> threads + i);
+    }
+
+    // All threads are stopped, so slots that no JOIN took report their failures here
+    for(size_t i = 0; i < MAX_THREADS; i++) {
+        int thread_error = 0;
+
+        guest_take(process -> threads + i, &thread_error);
+
+        error |= thread_error;
+    }
+
+    return error;
+}
+
+
+template <typename Policy>
+int show_ram(Process<Policy> *process) {
+    ASSERT(process -> screen, "Process has no screen!");
+
+    size_t size = (size_t) process -> screen -> width * process -> screen -> height;
+
+    ASSERT(process -> ram_size >= size, "Ram size is less then screen size!");
+
+    const int *cells = (const int *) process -> ram;
+
+    if (Policy::CELL != CELL_FIXED32) {
+        if (!process -> cells) {
+            process -> cells = (int *) calloc(size, sizeof(int));
+
+            ASSERT(process -> cells, "Can't allocate screen cells!");
+        }
+
+        for(size_t i = 0; i < size; i++)
+            process -> cells[i] = Policy::to_units(process -> ram[i], &process -> fixed);
+
+        cells = process -> cells;
+    }
+
+    if (process -> frames) {
+        ASSERT(!frames_write(process -> frames, cells), "Can't write frame!");
+
+        return 0;
+    }
+
+    ASSERT(!screen_show(process -> screen, cells, process -> screen -> file), "Can't draw screen!");
+
+    return 0;
+}
+
+
+template <typename Policy>
+static void parallel_worker(void *arg, size_t worker, size_t workers) {
+    typedef typename Policy::cell_t cell_t;
+
+    ParallelLoop<Policy> *loop = (ParallelLoop<Policy> *) arg;
+    Process<Policy> *process = loop -> process;
+
+    Process<Policy> body = *process;
+
+    body.trace = nullptr;
+    body.cells = nullptr;
+    body.body = 1;
+    body.quantum = 0;
+    body.root = 0;
+
+    body.value_stack = {};
+    body.call_stack = {};
+
+    body.reg = (cell_t *) calloc(REGISTER_SIZE, sizeof(cell_t));
+
+    if (!body.reg || stack_constructor(&body.value_stack, 4) || stack_constructor(&body.call_stack, 4)) {
+        printf("Can't create PARFOR worker!\n");
+        __atomic_store_n(&loop -> error, 1, __ATOMIC_SEQ_CST);
+    }
+    else
+        memcpy(body.reg, loop -> reg, REGISTER_SIZE * sizeof(cell_t));
+
+    long long total = loop -> end - loop -> start;
+    long long first = loop -> start + (long long)((__int128) total * (long long) worker / (long long) workers);
+    long long last = loop -> start + (long long)((__int128) total * (long long)(worker + 1) / (long long) workers);
+    long long chunk = (long long) process -> chunk;
+
+    while (!__atomic_load_n(&loop -> error, __ATOMIC_RELAXED)) {
+        // Dynamic chunking takes next range from shared counter
+        if (chunk) {
+            first = __atomic_fetch_add(&loop -> next, chunk, __ATOMIC_RELAXED);
+            last = (first < loop -> end - chunk) ? first + chunk : loop -> end;
+        }
+
+        if (first >= last) break;
+
+        for(long long i = first; i < last && !__atomic_load_n(&loop -> error, __ATOMIC_RELAXED); i++) {
+            body.reg[loop -> index] = Policy::from_int(i, &process -> fixed);
+            body.ip = process -> code + loop -> target;
+
+            stack_push(&body.call_stack, (int) process -> count);
+
+            if (execute(&body)) {
+                process_failed(&body);
+                __atomic_store_n(&loop -> error, 1, __ATOMIC_SEQ_CST);
+            }
+        }
+
+        if (!chunk) break;
+    }
+
+    heap_flush(body.heap);
+
+    free(body.reg);
+    free(body.cells);
+
+    stack_destructor(&body.value_stack);
+    stack_destructor(&body.call_stack);
+}
+
+
+template <typename Policy>
+int parallel_for(Process<Policy> *process, typename Policy::cell_t *reg, arg_t index, typename Policy::cell_t end, arg_t target) {
+    if (index < 0 || index >= (int) REGISTER_SIZE || target < 0 || (size_t) target >= process -> count) return 1;
+
+    ParallelLoop<Policy> loop = {};
+
+    loop.process = process;
+    loop.reg = reg;
+    loop.index = index;
+    loop.target = target;
+    loop.start = Policy::to_int(reg[index], &process -> fixed);
+    loop.end = Policy::to_int(end, &process -> fixed);
+    loop.next = loop.start;
+
+    if (loop.start >= loop.end) return 0;
+
+    // Busy pool means nested PARFOR or PARFOR of other guest thread, loop is executed by calling thread then
+    if (!process -> pool || pool_run(process -> pool, &parallel_worker<Policy>, &loop))
+        parallel_worker<Policy>(&loop, 0, 1);
+
+    reg[index] = Policy::from_int(loop.end, &process -> fixed);
+
+    return loop.error;
+}
 
-    fflush(stdout);
+
+template <typename Policy>
+int scheduler_constructor(Scheduler<Policy> *scheduler, const Program *program) {
+    ASSERT(scheduler && program, "Can't work with then null pointer!");
+
+    *scheduler = {};
+
+    ASSERT(!monitor_constructor(&scheduler -> monitor), "Can't create scheduler monitor!");
+
+    scheduler -> count = (program -> green_threads) ? program -> green_threads : 1;
+    scheduler -> quantum = (program -> quantum) ? program -> quantum : GREEN_QUANTUM;
+    scheduler -> ram_size = program -> green_ram_size;
+    scheduler -> huge = program -> huge;
+
+    return 0;
+}
+
+
+/**
+ * \brief Frees green process
+ * \param [in] green Process created by green_start()
+*/
+template <typename Policy>
+static void green_free(Process<Policy> *green) {
+    // Private RAM holds registers, otherwise they are allocated alone
+    if (green -> scheduler -> ram_size && green -> ram)
+        ram_unmap(green -> ram, green -> ram_size);
+    else
+        free(green -> reg);
+    free(green -> cells);
+
+    stack_destructor(&green -> value_stack);
+    stack_destructor(&green -> call_stack);
+
+    free(green);
+}
+
+
+/**
+ * \brief Adds process to the end of ready queue
+ * \param scheduler Scheduler with acquired lock
+ * \param [in] green Ready process
+ * \return Non zero value means error
+*/
+template <typename Policy>
+static int green_push(Scheduler<Policy> *scheduler, Process<Policy> *green) {
+    if (scheduler -> size == scheduler -> capacity) {
+        size_t capacity = (scheduler -> capacity) ? scheduler -> capacity * 2 : 64;
+
+        Process<Policy> **queue = (Process<Policy> **) calloc(capacity, sizeof(Process<Policy> *));
+
+        if (!queue) return 1;
+
+        for(size_t i = 0; i < scheduler -> size; i++)
+            queue[i] = scheduler -> queue[(scheduler -> head + i) % scheduler -> capacity];
+
+        free(scheduler -> queue);
+
+        scheduler -> queue = queue;
+        scheduler -> capacity = capacity;
+        scheduler -> head = 0;
+    }
+
+    scheduler -> queue[(scheduler -> head + scheduler -> size++) % scheduler -> capacity] = green;
+
+    monitor_wake(&scheduler -> monitor);
+
+    return 0;
+}
+
+
+template <typename Policy>
+static void green_main(void *arg) {
+    Scheduler<Policy> *scheduler = (Scheduler<Policy> *) arg;
+
+    // All green processes of scheduler share one heap
+    Heap<typename Policy::cell_t> *heap = nullptr;
+
+    monitor_lock(&scheduler -> monitor);
+
+    for(;;) {
+        while (!scheduler -> size && !scheduler -> stop)
+            monitor_wait(&scheduler -> monitor);
+
+        if (!scheduler -> size) break;
+
+        Process<Policy> *green = scheduler -> queue[scheduler -> head];
+
+        scheduler -> head = (scheduler -> head + 1) % scheduler -> capacity;
+        scheduler -> size--;
+
+        monitor_unlock(&scheduler -> monitor);
+
+        green -> yielded = 0;
+
+        heap = green -> heap;
+
+        int error = execute(green);
+
+        if (error)
+            process_failed(green);
+
+        monitor_lock(&scheduler -> monitor);
+
+        // Switched process goes to the end of queue, thread is given to other programs if nobody else is ready
+        if (!error && green -> yielded && !green_push(scheduler, green)) {
+            if (scheduler -> size == 1) {
+                monitor_unlock(&scheduler -> monitor);
+                thread_yield();
+                monitor_lock(&scheduler -> monitor);
+            }
+
+            continue;
+        }
+
+        if (!error && green -> yielded) {
+            printf("Can't continue green process!\n");
+            error = 1;
+        }
+
+        monitor_unlock(&scheduler -> monitor);
+
+        green_free(green);
+
+        monitor_lock(&scheduler -> monitor);
+
+        scheduler -> failed |= error;
+
+        if (!--scheduler -> live)
+            monitor_wake(&scheduler -> monitor);
+    }
+
+    monitor_unlock(&scheduler -> monitor);
+
+    heap_flush(heap);
+}
+
+
+template <typename Policy>
+int green_start(Process<Policy> *process, const typename Policy::cell_t *reg, arg_t target) {
+    typedef typename Policy::cell_t cell_t;
+
+    Scheduler<Policy> *scheduler = process -> scheduler;
+
+    if (!scheduler || target < 0 || (size_t) target >= process -> count) return 1;
+
+    Process<Policy> *green = (Process<Policy> *) calloc(1, sizeof(Process<Policy>));
+
+    if (!green) return 1;
+
+    *green = *process;
+
+    green -> ip = process -> code + target;
+    green -> trace = nullptr;
+    green -> cells = nullptr;
+    green -> body = 0;
+    green -> quantum = scheduler -> quantum;
+    green -> root = 0;
+
+    green -> value_stack = {};
+    green -> call_stack = {};
+
+    if (scheduler -> ram_size) {
+        green -> ram_size = scheduler -> ram_size;
+        green -> ram = ram_map<cell_t>(green -> ram_size, scheduler -> huge);
+        green -> ram_mask = ram_mask(green -> ram_size);
+        green -> reg = (green -> ram) ? ram_registers(green -> ram) : nullptr;
+    }
+    else
+        green -> reg = (cell_t *) calloc(REGISTER_SIZE, sizeof(cell_t));
+
+    if (!green -> reg || !green -> ram || stack_constructor(&green -> value_stack, 4) || stack_constructor(&green -> call_stack, 4)) {
+        green_free(green);
+        return 1;
+    }
+
+    memcpy(green -> reg, reg, REGISTER_SIZE * sizeof(cell_t));
+
+    monitor_lock(&scheduler -> monitor);
+
+    if (!scheduler -> threads) {
+        scheduler -> threads = (Thread *) calloc(scheduler -> count, sizeof(Thread));
+
+        size_t started = 0;
+
+        while (scheduler -> threads && started < scheduler -> count && !thread_start(scheduler -> threads + started, &green_main<Policy>, scheduler))
+            started++;
+
+        scheduler -> count = started;
+    }
+
+    int error = !scheduler -> count || green_push(scheduler, green);
+
+    scheduler -> live += !error;
+
+    monitor_unlock(&scheduler -> monitor);
+
+    if (error)
+        green_free(green);
+
+    return error;
+}
+
+
+template <typename Policy>
+int scheduler_destructor(Scheduler<Policy> *scheduler) {
+    monitor_lock(&scheduler -> monitor);
+
+    while (scheduler -> live)
+        monitor_wait(&scheduler -> monitor);
+
+    scheduler -> stop = 1;
+
+    monitor_wake(&scheduler -> monitor);
+    monitor_unlock(&scheduler -> monitor);
+
+    for(size_t i = 0; scheduler -> threads && i < scheduler -> count; i++)
+        thread_join(scheduler -> threads + i);
+
+    int failed = scheduler -> failed;
+
+    free(scheduler -> threads);
+    free(scheduler -> queue);
+
+    monitor_destructor(&scheduler -> monitor);
+
+    *scheduler = {};
+
+    return failed;
+}
+
+
+template <typename Policy>
+long long fork_process(Process<Policy> *process) {
+#ifdef __linux__
+    if (!process -> root) return -1;
+
+    for(size_t i = 0; process -> threads && i < MAX_THREADS; i++)
+        if (__atomic_load_n(&process -> threads[i].state, __ATOMIC_SEQ_CST) != THREAD_FREE) return -1;
+
+    Scheduler<Policy> *scheduler = process -> scheduler;
+
+    if (scheduler) {
+        monitor_lock(&scheduler -> monitor);
+        size_t live = scheduler -> live;
+        monitor_unlock(&scheduler -> monitor);
+
+        if (live) return -1;
+    }
+
+    int *children = (int *) realloc(process -> children, (process -> forks + 1) * sizeof(int));
+
+    if (!children) return -1;
+
+    process -> children = children;
+
+    // Buffered output would be written by both processes
+    fflush(nullptr);
+
+    pid_t pid = fork();
+
+    if (pid == -1) return -1;
+
+    if (pid) {
+        process -> children[process -> forks++] = pid;
+        return (long long) process -> forks;
+    }
+
+    process -> forked = 1;
+    process -> children = nullptr;
+    process -> forks = 0;
+
+    // Threads of parent don't exist in child, new ones are started on demand
+    if (process -> pool && pool_forget(process -> pool))
+        process -> pool = nullptr;
+
+    if (scheduler && scheduler -> threads) {
+        free(scheduler -> threads);
+        scheduler -> threads = nullptr;
+
+        if (monitor_forget(&scheduler -> monitor))
+            process -> scheduler = nullptr;
+    }
 
     return 0;
+#else
+    (void) process;
+
+    printf("FORK is not supported on this system!\n");
+    return -1;
+#endif
 }
 
+
+template <typename Policy>
+int wait_children(Process<Policy> *process) {
+    int failed = 0;
+
+#ifdef __linux__
+    for(size_t i = 0; i < process -> forks; i++) {
+        int status = 0;
+
+        if (waitpid(process -> children[i], &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status))
+            failed = 1;
+    }
+#endif
+
+    free(process -> children);
+
+    process -> children = nullptr;
+    process -> forks = 0;
+
+    return failed;
+}
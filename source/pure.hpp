@@ -0,0 +1,178 @@
+/**
+ * \file
+ * \brief Pure routines: CALL of routine that starts with PURE takes results from cache or executes routine at once
+ * \note Routine has to depend only on its input stack slots and registers given to PURE and change only the stack
+ * \note Include it after Process and execute() are declared
+ * \note Missed routine is executed by nested execute(), routines nested deeper than PURE_DEPTH are executed as plain CALL and aren't cached
+*/
+
+
+/// Cached call of pure routine
+template <typename cell_t>
+struct PureEntry {
+    arg_t target = -1;                  ///< Routine offset (-1 for free entry)
+    cell_t key[PURE_VALUES] = {};       ///< Input stack slots, then registers
+    cell_t result[PURE_VALUES] = {};    ///< Results in stack order
+};
+
+
+/// Direct mapped cache of pure routine calls shared by all threads of program
+template <typename cell_t>
+struct PureCache {
+    Monitor monitor = {};                   ///< Protects entries and counters
+    PureEntry<cell_t> *entries = nullptr;   ///< Entries
+    size_t size = 0;                        ///< Entry count
+    size_t hits = 0;                        ///< Calls that took results from cache
+    size_t misses = 0;                      ///< Calls that executed routine
+};
+
+
+/**
+ * \brief Creates cache
+ * \param [out] cache Cache to create
+ * \param [in]  size Entry count
+ * \return Non zero value means error
+*/
+template <typename cell_t>
+int pure_constructor(PureCache<cell_t> *cache, size_t size) {
+    ASSERT(cache && size, "Invalid pure call cache!");
+
+    cache -> entries = (PureEntry<cell_t> *) calloc(size, sizeof(PureEntry<cell_t>));
+
+    ASSERT(cache -> entries, "Can't allocate pure call cache!");
+
+    for(size_t i = 0; i < size; i++)
+        cache -> entries[i].target = -1;
+
+    cache -> size = size;
+
+    if (monitor_constructor(&cache -> monitor)) {
+        free(cache -> entries);
+        cache -> entries = nullptr;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+/**
+ * \brief Frees cache
+ * \param [in] cache Cache to free
+*/
+template <typename cell_t>
+void pure_destructor(PureCache<cell_t> *cache) {
+    if (!cache -> entries) return;
+
+    free(cache -> entries);
+
+    monitor_destructor(&cache -> monitor);
+
+    *cache = {};
+}
+
+
+/**
+ * \brief Calls pure routine: pops its inputs and pushes results from cache or executes it at once
+ * \param process Process that executes CALL
+ * \param reg Registers
+ * \param [in] target Routine offset
+ * \param [in] pure PURE arguments at routine start
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int pure_call(Process<Policy> *process, typename Policy::cell_t *reg, arg_t target, const cmd_t *pure) {
+    typedef typename Policy::cell_t cell_t;
+
+    PureCache<cell_t> *cache = process -> pure;
+    Stack<cell_t> *stack = &(process -> value_stack);
+
+    size_t inputs = pure[0], outputs = pure[1];
+
+    ASSERT((size_t) stack -> size >= inputs, "Not enough inputs for pure routine!");
+
+    cell_t key[PURE_VALUES] = {};
+    size_t count = inputs;
+
+    memcpy(key, stack -> data + (size_t) stack -> size - inputs, inputs * sizeof(cell_t));
+
+    for(size_t i = 0; i < REGISTER_SIZE && count < PURE_VALUES; i++)
+        if (pure[2] & (1 << i)) key[count++] = reg[i];
+
+    // FNV-1a of routine and its inputs
+    unsigned long long hash = 14695981039346656037ull ^ (unsigned long long) target;
+
+    for(size_t i = 0; i < count * sizeof(cell_t); i++)
+        hash = (hash ^ ((const unsigned char *) key)[i]) * 1099511628211ull;
+
+    PureEntry<cell_t> *entry = cache -> entries + hash % cache -> size;
+
+    monitor_lock(&cache -> monitor);
+
+    if (entry -> target == target && !memcmp(entry -> key, key, count * sizeof(cell_t))) {
+        cache -> hits++;
+
+        cell_t result[PURE_VALUES] = {};
+
+        memcpy(result, entry -> result, outputs * sizeof(cell_t));
+
+        monitor_unlock(&cache -> monitor);
+
+        for(size_t i = 0; i < inputs; i++)
+            ASSERT(!stack_pop(stack, key), "Stack pop error!");
+
+        for(size_t i = 0; i < outputs; i++)
+            ASSERT(!stack_push(stack, result[i]), "Stack push error!");
+
+        return 0;
+    }
+
+    cache -> misses++;
+
+    monitor_unlock(&cache -> monitor);
+
+    // Routine returns to the end of code, so nested execute() stops right after its RET
+    Process<Policy> call = *process;
+
+    call.ip = process -> code + target;
+    call.body = 1;
+    call.quantum = 0;
+    call.pure_depth = process -> pure_depth + 1;
+
+    // The last nested execute() runs deeper calls on call stack, so recursion doesn't overflow thread stack
+    if (call.pure_depth == PURE_DEPTH)
+        call.pure = nullptr;
+
+    if (reg != process -> reg)
+        memcpy(process -> reg, reg, REGISTER_SIZE * sizeof(cell_t));
+
+    int depth = process -> call_stack.size;
+    size_t results = (size_t) stack -> size - inputs + outputs;
+
+    ASSERT(!stack_push(&call.call_stack, (int) process -> count), "Stack push error!");
+
+    int error = execute(&call);
+
+    // Stacks could be reallocated
+    process -> value_stack = call.value_stack;
+    process -> call_stack = call.call_stack;
+
+    if (reg != process -> reg)
+        memcpy(reg, process -> reg, REGISTER_SIZE * sizeof(cell_t));
+
+    if (error) return 1;
+
+    ASSERT(process -> call_stack.size == depth, "Pure routine didn't return!");
+    ASSERT((size_t) stack -> size == results, "Pure routine left wrong number of results!");
+
+    monitor_lock(&cache -> monitor);
+
+    entry -> target = target;
+
+    memcpy(entry -> key, key, count * sizeof(cell_t));
+    memcpy(entry -> result, stack -> data + results - outputs, outputs * sizeof(cell_t));
+
+    monitor_unlock(&cache -> monitor);
+
+    return 0;
+}
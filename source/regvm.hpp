@@ -0,0 +1,725 @@
+/**
+ * \file
+ * \brief Register machine: stack code is compiled at load time into three-address code
+ * \note Values pushed inside basic block live in virtual registers, real stack is used only at block borders
+ * \note Include it after blocks.hpp while DEF_CMD is defined, fallback operations reuse handlers from cmd.hpp
+*/
+
+
+/// Register code operations
+typedef enum {
+    REG_HLT   =  0, ///< Stops the process
+    REG_END   =  1, ///< End of code without hlt
+    REG_MOV   =  2, ///< dst = a
+    REG_ADD   =  3, ///< dst = a + b
+    REG_SUB   =  4, ///< dst = a - b
+    REG_MUL   =  5, ///< dst = a * b
+    REG_DIV   =  6, ///< dst = a / b
+    REG_SQRT  =  7, ///< dst = sqrt(a)
+    REG_LOAD  =  8, ///< dst = ram[a + b]
+    REG_STORE =  9, ///< ram[a + b] = dst
+    REG_PUSH  = 10, ///< Pushes a to value stack
+    REG_POP   = 11, ///< Pops dst from value stack
+    REG_IN    = 12, ///< Reads dst from channel 0
+    REG_OUT   = 13, ///< Writes a to channel 0
+    REG_JMP   = 14, ///< Jumps to dst
+    REG_JB    = 15, ///< Jumps to dst if a < b
+    REG_JA    = 16, ///< Jumps to dst if a > b
+    REG_JE    = 17, ///< Jumps to dst if a == b
+    REG_JNE   = 18, ///< Jumps to dst if a != b
+    REG_JAE   = 19, ///< Jumps to dst if a >= b
+    REG_JBE   = 20, ///< Jumps to dst if a <= b
+    REG_CALL  = 21, ///< Jumps to dst and remembers next operation
+    REG_RET   = 22, ///< Returns to remembered operation
+    REG_STACK = 23, ///< Executes stack command at offset dst with handler from cmd.hpp
+} REG_OPS;
+
+
+/// Three-address operation
+typedef struct {
+    int op = REG_HLT;           ///< One of REG_OPS
+    int dst = 0;                ///< Destination register (source for REG_STORE, operation index for jumps)
+    int a = 0;                  ///< First source register
+    int b = 0;                  ///< Second source register
+    unsigned int offset = 0;    ///< Offset of stack command it was compiled from
+    unsigned short code = 0;    ///< Stack command code (for trace)
+    cmd_t flags = 0;            ///< Stack command argument bits (for trace)
+} RegOp;
+
+
+/// Compiled program
+template <typename cell_t>
+struct RegCode {
+    RegOp *ops = nullptr;       ///< Operations
+    size_t count = 0;           ///< Operation count
+    size_t capacity = 0;        ///< Allocated operations
+
+    cell_t *file = nullptr;     ///< Register file: process registers, then constants, then temporaries
+    size_t size = 0;            ///< Register file size
+
+    cell_t *consts = nullptr;   ///< Constant values
+    size_t consts_count = 0;    ///< Number of constants
+    size_t temps = 0;           ///< Maximum number of temporaries in one block
+
+    int *stack = nullptr;       ///< Registers that hold values of value stack inside current block
+    size_t depth = 0;           ///< Number of values in stack
+    size_t temps_used = 0;      ///< Temporaries used in current block
+
+    size_t blocks = 0;          ///< Number of basic blocks
+};
+
+
+/// Trace compiler (jit.hpp)
+template <typename Policy>
+struct Jit;
+
+
+/**
+ * \brief Counts backward jump to loop head, starts recording or runs compiled trace
+ * \return Index of operation to continue with
+*/
+template <typename Policy>
+int jit_enter(Jit<Policy> *jit, int head);
+
+
+/**
+ * \brief Adds operation to recorded trace, compiles and runs trace when loop is closed
+ * \return Index of operation to continue with or -1 to execute this operation
+*/
+template <typename Policy>
+int jit_record(Jit<Policy> *jit, int index);
+
+
+/// Register operand tag for constants (replaced with register file index after compilation)
+const int REG_CONST_TAG = 1 << 29;
+
+/// Register operand tag for temporaries (replaced with register file index after compilation)
+const int REG_TEMP_TAG = 1 << 30;
+
+
+/**
+ * \brief Compiles process code into register code
+ * \param [in]  process Process with stack code
+ * \param [out] regcode Register code
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int regvm_compile(Process<Policy> *process, RegCode<typename Policy::cell_t> *regcode);
+
+
+/**
+ * \brief Executes register code and copies process registers back
+ * \param process Process to execute
+ * \param [in] regcode Compiled code
+ * \param jit Trace compiler for hot loops (nullptr if loops are only interpreted)
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int regvm_execute(Process<Policy> *process, RegCode<typename Policy::cell_t> *regcode, Jit<Policy> *jit);
+
+
+/**
+ * \brief Frees register code
+ * \param [in] regcode Code to free
+*/
+template <typename cell_t>
+void regvm_free(RegCode<cell_t> *regcode);
+
+
+
+
+/// Appends operation (returns non zero value on allocation error)
+template <typename cell_t>
+static int regvm_emit(RegCode<cell_t> *regcode, int op, int dst, int a, int b, const RegOp *source) {
+    if (regcode -> count == regcode -> capacity) {
+        size_t capacity = (regcode -> capacity) ? regcode -> capacity * 2 : 64;
+        RegOp *ops = (RegOp *) realloc(regcode -> ops, capacity * sizeof(RegOp));
+
+        if (!ops) return 1;
+
+        regcode -> ops = ops;
+        regcode -> capacity = capacity;
+    }
+
+    RegOp *new_op = regcode -> ops + regcode -> count++;
+
+    *new_op = *source;
+    new_op -> op = op;
+    new_op -> dst = dst;
+    new_op -> a = a;
+    new_op -> b = b;
+
+    return 0;
+}
+
+
+/// Returns new temporary register of current block
+template <typename cell_t>
+static int regvm_temp(RegCode<cell_t> *regcode) {
+    if (++regcode -> temps_used > regcode -> temps)
+        regcode -> temps = regcode -> temps_used;
+
+    return REG_TEMP_TAG | (int)(regcode -> temps_used - 1);
+}
+
+
+/// Returns register holding constant (-1 on allocation error)
+template <typename cell_t>
+static int regvm_const(RegCode<cell_t> *regcode, cell_t value) {
+    for(size_t i = 0; i < regcode -> consts_count; i++)
+        if (!memcmp(regcode -> consts + i, &value, sizeof(cell_t))) return REG_CONST_TAG | (int) i;
+
+    cell_t *consts = (cell_t *) realloc(regcode -> consts, (regcode -> consts_count + 1) * sizeof(cell_t));
+
+    if (!consts) return -1;
+
+    regcode -> consts = consts;
+    regcode -> consts[regcode -> consts_count] = value;
+
+    return REG_CONST_TAG | (int)(regcode -> consts_count++);
+}
+
+
+/// Pushes register to compile time stack (returns non zero value on allocation error)
+template <typename cell_t>
+static int regvm_push(RegCode<cell_t> *regcode, int reg, size_t *capacity) {
+    if (regcode -> depth == *capacity) {
+        size_t new_capacity = (*capacity) ? *capacity * 2 : 16;
+        int *stack = (int *) realloc(regcode -> stack, new_capacity * sizeof(int));
+
+        if (!stack) return 1;
+
+        regcode -> stack = stack;
+        *capacity = new_capacity;
+    }
+
+    regcode -> stack[regcode -> depth++] = reg;
+
+    return 0;
+}
+
+
+/// Pops register from compile time stack or emits real stack pop if block stack is empty (-1 on error)
+template <typename cell_t>
+static int regvm_pop(RegCode<cell_t> *regcode, const RegOp *source) {
+    if (regcode -> depth)
+        return regcode -> stack[--regcode -> depth];
+
+    int reg = regvm_temp(regcode);
+
+    return regvm_emit(regcode, REG_POP, reg, 0, 0, source) ? -1 : reg;
+}
+
+
+/// Moves all values of compile time stack to real stack
+template <typename cell_t>
+static int regvm_flush(RegCode<cell_t> *regcode, const RegOp *source) {
+    for(size_t i = 0; i < regcode -> depth; i++)
+        if (regvm_emit(regcode, REG_PUSH, 0, regcode -> stack[i], 0, source)) return 1;
+
+    regcode -> depth = 0;
+
+    return 0;
+}
+
+
+/// Copies process register to temporary if compile time stack refers to it (call before writing the register)
+template <typename cell_t>
+static int regvm_write(RegCode<cell_t> *regcode, int reg, const RegOp *source) {
+    int copy = -1;
+
+    for(size_t i = 0; i < regcode -> depth; i++) {
+        if (regcode -> stack[i] != reg) continue;
+
+        if (copy == -1) {
+            copy = regvm_temp(regcode);
+
+            if (regvm_emit(regcode, REG_MOV, copy, reg, 0, source)) return 1;
+        }
+
+        regcode -> stack[i] = copy;
+    }
+
+    return 0;
+}
+
+
+/// Compiles one stack command (returns non zero value on error)
+template <typename Policy>
+static int regvm_command(RegCode<typename Policy::cell_t> *regcode, const cmd_t *args, const RegOp *source, size_t *capacity, const Fixed *fixed) {
+    typedef typename Policy::cell_t cell_t;
+
+    #define REG_CHECK_(cond) do { if (!(cond)) return 1; } while(0)
+    #define REG_EMIT_(op, dst, a, b) REG_CHECK_(!regvm_emit(regcode, op, dst, a, b, source))
+    #define REG_POP_(var) int var = regvm_pop(regcode, source); REG_CHECK_(var != -1)
+    #define REG_PUSH_(reg) REG_CHECK_(!regvm_push(regcode, reg, capacity))
+    #define REG_ARG_(var) int var = *((const arg_t *)(args)); args += sizeof(arg_t)
+    #define REG_CELL_(var) int var = regvm_const(regcode, *((const cell_t *)(args))); args += sizeof(cell_t); REG_CHECK_(var != -1)
+    #define REG_SRC_(var) int var = 0; if (source -> flags & BIT_CONST) { REG_CELL_(value_); var = value_; } else { REG_ARG_(reg_); var = reg_; }
+
+    cmd_t flags = source -> flags;
+    int op = REG_HLT;
+
+    switch (source -> code) {
+        case CMD_HLT:
+            REG_EMIT_(REG_HLT, 0, 0, 0);
+            return 0;
+
+        case CMD_PUSH: {
+            int a = 0, b = 0, zero = regvm_const(regcode, (cell_t) 0);
+
+            REG_CHECK_(zero != -1);
+
+            if (flags & BIT_CONST) { REG_CELL_(value); a = value; } else a = zero;
+            if (flags & BIT_REG)   { REG_ARG_(reg);    b = reg;   } else b = zero;
+
+            if (flags & BIT_MEM) {
+                int temp = regvm_temp(regcode);
+                REG_EMIT_(REG_LOAD, temp, a, b);
+                REG_PUSH_(temp);
+            }
+            else if ((flags & BIT_CONST) && (flags & BIT_REG)) {
+                int temp = regvm_temp(regcode);
+                REG_EMIT_(REG_ADD, temp, a, b);
+                REG_PUSH_(temp);
+            }
+            else
+                REG_PUSH_((flags & BIT_CONST) ? a : b);
+
+            return 0;
+        }
+
+        case CMD_POP: {
+            if (flags & BIT_MEM) {
+                int a = 0, b = 0, zero = regvm_const(regcode, (cell_t) 0);
+
+                REG_CHECK_(zero != -1);
+
+                if (flags & BIT_CONST) { REG_CELL_(value); a = value; } else a = zero;
+                if (flags & BIT_REG)   { REG_ARG_(reg);    b = reg;   } else b = zero;
+
+                REG_POP_(value);
+                REG_EMIT_(REG_STORE, value, a, b);
+            }
+            else if (flags & BIT_REG) {
+                REG_ARG_(reg);
+                REG_CHECK_(reg > -1 && reg < (int) REGISTER_SIZE);
+                REG_POP_(value);
+
+                RegOp *last = (regcode -> count) ? regcode -> ops + regcode -> count - 1 : nullptr;
+                int aliased = 0;
+
+                for(size_t i = 0; i < regcode -> depth; i++)
+                    aliased |= (regcode -> stack[i] == reg || regcode -> stack[i] == value);
+
+                // Result of the previous operation is written straight into the register
+                int writes = last && ((last -> op >= REG_MOV && last -> op <= REG_LOAD) || last -> op == REG_POP || last -> op == REG_IN);
+
+                if (writes && last -> dst == value && (value & REG_TEMP_TAG) && !aliased)
+                    last -> dst = reg;
+                else {
+                    REG_CHECK_(!regvm_write(regcode, reg, source));
+                    REG_EMIT_(REG_MOV, reg, value, 0);
+                }
+            }
+            else {
+                REG_POP_(value);
+            }
+
+            return 0;
+        }
+
+        case CMD_ADD: op = REG_ADD; break;
+        case CMD_SUB: op = REG_SUB; break;
+        case CMD_MUL: op = REG_MUL; break;
+        case CMD_DIV: op = REG_DIV; break;
+
+        case CMD_JB:  op = REG_JB;  break;
+        case CMD_JA:  op = REG_JA;  break;
+        case CMD_JE:  op = REG_JE;  break;
+        case CMD_JNE: op = REG_JNE; break;
+        case CMD_JAE: op = REG_JAE; break;
+        case CMD_JBE: op = REG_JBE; break;
+
+        case CMD_DUP: {
+            REG_POP_(value);
+            REG_PUSH_(value);
+            REG_PUSH_(value);
+            return 0;
+        }
+
+        case CMD_SQRT: {
+            REG_POP_(value);
+            int temp = regvm_temp(regcode);
+            REG_EMIT_(REG_SQRT, temp, value, 0);
+            REG_PUSH_(temp);
+            return 0;
+        }
+
+        case CMD_IN: {
+            int temp = regvm_temp(regcode);
+            REG_EMIT_(REG_IN, temp, 0, 0);
+            REG_PUSH_(temp);
+            return 0;
+        }
+
+        case CMD_OUT: {
+            REG_POP_(value);
+            REG_EMIT_(REG_OUT, 0, value, 0);
+            return 0;
+        }
+
+        case CMD_JMP: case CMD_CALL: {
+            REG_CHECK_(!regvm_flush(regcode, source));
+            REG_EMIT_((source -> code == CMD_JMP) ? REG_JMP : REG_CALL, *((const arg_t *)(args)), 0, 0);
+            return 0;
+        }
+
+        case CMD_RET: {
+            REG_CHECK_(!regvm_flush(regcode, source));
+            REG_EMIT_(REG_RET, 0, 0, 0);
+            return 0;
+        }
+
+        case CMD_INC: case CMD_DEC: {
+            REG_ARG_(reg);
+            int one = regvm_const(regcode, Policy::from_int(1, fixed));
+            REG_CHECK_(one != -1 && reg > -1 && reg < (int) REGISTER_SIZE);
+            REG_CHECK_(!regvm_write(regcode, reg, source));
+            REG_EMIT_((source -> code == CMD_INC) ? REG_ADD : REG_SUB, reg, reg, one);
+            return 0;
+        }
+
+        case CMD_MOV: {
+            REG_ARG_(reg);
+            REG_SRC_(value);
+            REG_CHECK_(reg > -1 && reg < (int) REGISTER_SIZE);
+            REG_CHECK_(!regvm_write(regcode, reg, source));
+            REG_EMIT_(REG_MOV, reg, value, 0);
+            return 0;
+        }
+
+        // Call stack of register code keeps operation indexes, so snapshot is made by stack code
+        case CMD_SNAPSHOT:
+            return 1;
+
+        // Marker is read by CALL only
+        case CMD_PURE:
+            return 0;
+
+        default: {
+            REG_CHECK_(!regvm_flush(regcode, source));
+            REG_EMIT_(REG_STACK, (int) source -> offset, 0, 0);
+            return 0;
+        }
+    }
+
+    // Binary operations and conditional jumps
+    int a = 0, b = 0, dst = 0;
+
+    if (flags & BIT_REG) {
+        REG_ARG_(reg);
+        REG_SRC_(value);
+        REG_CHECK_(reg > -1 && reg < (int) REGISTER_SIZE);
+        a = dst = reg;
+        b = value;
+
+        if (op < REG_JMP)
+            REG_CHECK_(!regvm_write(regcode, reg, source));
+    }
+    else {
+        REG_POP_(val1);
+        REG_POP_(val2);
+        a = val2;
+        b = val1;
+
+        if (op < REG_JMP) {
+            dst = regvm_temp(regcode);
+            REG_PUSH_(dst);
+        }
+    }
+
+    if (op >= REG_JMP) {
+        REG_CHECK_(!regvm_flush(regcode, source));
+        dst = *((const arg_t *)(args));
+    }
+
+    REG_EMIT_(op, dst, a, b);
+
+    return 0;
+
+    #undef REG_CHECK_
+    #undef REG_EMIT_
+    #undef REG_POP_
+    #undef REG_PUSH_
+    #undef REG_ARG_
+    #undef REG_CELL_
+    #undef REG_SRC_
+}
+
+
+/// Replaces operand tags with register file indexes
+static int regvm_relocate(int reg, size_t consts) {
+    if (reg & REG_TEMP_TAG)  return (int)(REGISTER_SIZE + consts) + (reg & ~REG_TEMP_TAG);
+    if (reg & REG_CONST_TAG) return (int) REGISTER_SIZE + (reg & ~REG_CONST_TAG);
+
+    return reg;
+}
+
+
+template <typename Policy>
+int regvm_compile(Process<Policy> *process, RegCode<typename Policy::cell_t> *regcode) {
+    typedef typename Policy::cell_t cell_t;
+
+    ASSERT(process && regcode, "Can't work with then null pointer!");
+
+    size_t count = process -> count;
+
+    // Block and command starts, operation index of every command
+    cmd_t *marks = (cmd_t *) calloc(count + 1, sizeof(cmd_t));
+    int *index = (int *) calloc(count + 1, sizeof(int));
+    size_t capacity = 0;
+
+    ASSERT(marks && index, "Can't allocate register compiler!");
+
+    blocks_mark<cell_t>(process -> code, count, marks);
+
+    for(size_t offset = 0; offset < count;) {
+        RegOp source = {};
+        const cmd_t *args = process -> code + offset;
+        cmd_t cmd = *args++;
+        unsigned int code = cmd & CMD_MASK;
+
+        if (code == CMD_EXT)
+            code += *args++;
+
+        source.offset = (unsigned int) offset;
+        source.code = (unsigned short) code;
+        source.flags = (cmd_t)(cmd & ~CMD_MASK);
+
+        if (marks[offset] & MARK_BLOCK) {
+            if (regvm_flush(regcode, &source)) break;
+
+            regcode -> temps_used = 0;
+            regcode -> blocks++;
+        }
+
+        index[offset] = (int) regcode -> count;
+
+        // Call of pure routine is executed by stack code, so results can be taken from cache
+        int pure = code == CMD_CALL && process -> pure && command_pure(process -> code, count, *((const arg_t *)(args)));
+
+        if (pure) {
+            if (regvm_flush(regcode, &source) || regvm_emit(regcode, REG_STACK, (int) offset, 0, 0, &source)) break;
+        }
+        else if (regvm_command<Policy>(regcode, args, &source, &capacity, &process -> fixed)) {
+            fprintf(stderr, "Register code: command %u at %zu has no register form, stack code is used\n", code, offset);
+            free(marks);
+            free(index);
+            return 1;
+        }
+
+        offset = (size_t)(args - process -> code) + command_args_size<cell_t>(code, source.flags);
+    }
+
+    RegOp end = {};
+    end.offset = (unsigned int) count;
+
+    ASSERT(!regvm_flush(regcode, &end) && !regvm_emit(regcode, REG_END, 0, 0, 0, &end), "Can't allocate register code!");
+
+    for(size_t i = 0; i < regcode -> count; i++) {
+        RegOp *op = regcode -> ops + i;
+
+        if (op -> op >= REG_JMP && op -> op <= REG_CALL) {
+            int target = op -> dst;
+
+            op -> dst = (target > -1 && (size_t) target < count && (marks[target] & MARK_COMMAND)) ? index[target] : -1;
+        }
+        else if (op -> op != REG_STACK) {
+            op -> dst = regvm_relocate(op -> dst, regcode -> consts_count);
+        }
+
+        op -> a = regvm_relocate(op -> a, regcode -> consts_count);
+        op -> b = regvm_relocate(op -> b, regcode -> consts_count);
+    }
+
+    free(marks);
+    free(index);
+
+    regcode -> size = REGISTER_SIZE + regcode -> consts_count + regcode -> temps;
+    regcode -> file = (cell_t *) calloc(regcode -> size, sizeof(cell_t));
+
+    ASSERT(regcode -> file, "Can't allocate register file!");
+
+    memcpy(regcode -> file + REGISTER_SIZE, regcode -> consts, regcode -> consts_count * sizeof(cell_t));
+
+    return 0;
+}
+
+
+/// Executes register code
+template <typename Policy>
+static int regvm_loop(Process<Policy> *process, RegCode<typename Policy::cell_t> *regcode, Jit<Policy> *jit) {
+    typedef typename Policy::cell_t cell_t;
+
+    /// SHORTCUTS ///
+    const RegOp *ops = regcode -> ops;
+    const RegOp *current = ops;
+
+    cell_t *file = regcode -> file;
+
+    Stack<cell_t> *stack = &(process -> value_stack);
+    Stack<int> *call_stack = &(process -> call_stack);
+
+    cell_t *reg = file;
+    cell_t *ram = process -> ram;
+
+    const Fixed *fixed = &(process -> fixed);
+
+    #define REG_JMP_IF_(condition)                                                          \
+        if (condition) {                                                                    \
+            ASSERT_IP(op -> dst > -1, "Jump to -1!", (size_t) op -> offset);                \
+            current = ops + op -> dst;                                                      \
+                                                                                            \
+            if (jit && current <= op)                                                       \
+                current = ops + jit_enter(jit, op -> dst);                                  \
+        }                                                                                   \
+        do {} while(0)
+
+    for(;;) {
+        const RegOp *op = current++;
+
+        if (jit && jit -> head > -1) {
+            int next = jit_record(jit, (int)(op - ops));
+
+            if (next > -1) {
+                current = ops + next;
+                continue;
+            }
+        }
+
+        switch (op -> op) {
+            case REG_HLT: return 0;
+
+            case REG_END:
+                printf("[Warning] No hlt at end of the process!\n");
+                return 0;
+
+            case REG_MOV: file[op -> dst] = file[op -> a];                                  break;
+            case REG_ADD: file[op -> dst] = file[op -> a] + file[op -> b];                  break;
+            case REG_SUB: file[op -> dst] = file[op -> a] - file[op -> b];                  break;
+            case REG_MUL: file[op -> dst] = Policy::mul(file[op -> a], file[op -> b], fixed); break;
+
+            case REG_DIV:
+                ASSERT_IP(!Policy::equal(file[op -> b], 0), "Zero division!", (size_t) op -> offset);
+                file[op -> dst] = Policy::div(file[op -> a], file[op -> b], fixed);
+                break;
+
+            case REG_SQRT:
+                ASSERT_IP(file[op -> a] >= 0, "Negative number under root!", (size_t) op -> offset);
+                file[op -> dst] = Policy::sqrt(file[op -> a], fixed);
+                break;
+
+            case REG_LOAD: case REG_STORE: {
+                long long index = Policy::to_int(file[op -> a] + file[op -> b], fixed);
+
+                RAM_INDEX_(index, (size_t) op -> offset);
+
+                if (op -> op == REG_LOAD)
+                    file[op -> dst] = ram[index];
+                else
+                    ram[index] = file[op -> dst];
+
+                break;
+            }
+
+            case REG_PUSH:
+                ASSERT_IP(!stack_push(stack, file[op -> a]), "Stack push error!", (size_t) op -> offset);
+                break;
+
+            case REG_POP:
+                ASSERT_IP(!stack_pop(stack, file + op -> dst), "Empty stack pop!", (size_t) op -> offset);
+                break;
+
+            case REG_IN:
+                file[op -> dst] = 0;
+
+                if (!io_end(process -> io))
+                    ASSERT_IP(io_read(process -> io, file + op -> dst, 1, fixed) == 1, "Wrong argument given!", (size_t) op -> offset);
+
+                break;
+
+            case REG_OUT:
+                ASSERT_IP(io_write(process -> io, file + op -> a, 1, fixed) == 1, "Can't write value!", (size_t) op -> offset);
+                break;
+
+            case REG_JMP: REG_JMP_IF_(1);                                                   break;
+            case REG_JB:  REG_JMP_IF_(file[op -> a] < file[op -> b]);                       break;
+            case REG_JA:  REG_JMP_IF_(file[op -> a] > file[op -> b]);                       break;
+            case REG_JE:  REG_JMP_IF_(Policy::equal(file[op -> a], file[op -> b]));         break;
+            case REG_JNE: REG_JMP_IF_(!Policy::equal(file[op -> a], file[op -> b]));        break;
+            case REG_JAE: REG_JMP_IF_(file[op -> a] >= file[op -> b]);                      break;
+            case REG_JBE: REG_JMP_IF_(file[op -> a] <= file[op -> b]);                      break;
+
+            case REG_CALL:
+                stack_push(call_stack, (int)(current - ops));
+                REG_JMP_IF_(1);
+                break;
+
+            case REG_RET: {
+                int index = 0;
+                ASSERT_IP(!stack_pop(call_stack, &index), "Empty call stack pop!", (size_t) op -> offset);
+                current = ops + index;
+                break;
+            }
+
+            case REG_STACK: {
+                const cmd_t *ip = process -> code + op -> dst;
+                cmd_t cmd = *ip++;
+                unsigned int code = cmd & CMD_MASK;
+
+                if (code == CMD_EXT)
+                    code += *ip++;
+
+                switch (code) {
+                    #include "cmd.hpp"
+
+                    default: {
+                        printf("Unknown command %u in operation %zu!\n", code, OFFSET(ip - 1));
+                        return 1;
+                    }
+                }
+
+                break;
+            }
+
+            default: {
+                printf("Unknown register operation %i!\n", op -> op);
+                return 1;
+            }
+        }
+    }
+
+    #undef REG_JMP_IF_
+}
+
+
+template <typename Policy>
+int regvm_execute(Process<Policy> *process, RegCode<typename Policy::cell_t> *regcode, Jit<Policy> *jit) {
+    int error = regvm_loop(process, regcode, jit);
+
+    memcpy(process -> reg, regcode -> file, REGISTER_SIZE * sizeof(*process -> reg));
+
+    return error;
+}
+
+
+template <typename cell_t>
+void regvm_free(RegCode<cell_t> *regcode) {
+    free(regcode -> ops);
+    free(regcode -> file);
+    free(regcode -> consts);
+    free(regcode -> stack);
+
+    *regcode = {};
+}
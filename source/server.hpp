@@ -0,0 +1,437 @@
+/**
+ * \file
+ * \brief Execution server: binary files are loaded once and executed by requests over Unix socket
+ * \note Request is one line: "load <name>" followed by binary file, "run <name|hash>" followed by input or "stop"
+ * \note Failed run ends its output with line "error <message>"
+ * \note Include it after run_program() and blocks.hpp
+*/
+
+
+/// Maximum number of programs loaded to server
+const size_t SERVER_PROGRAMS = 64;
+
+/// Maximum length of request line
+const size_t SERVER_LINE = 128;
+
+/// Maximum number of clients waiting for accept
+const int SERVER_BACKLOG = 64;
+
+
+/// Program loaded to server
+typedef struct {
+    char name[SERVER_LINE] = "";        ///< Name given by load request
+    unsigned long long hash = 0;        ///< FNV-1a hash of code and its format
+    Program program = {};               ///< Loaded program with settings of server
+    BlockCode blockcode = {};           ///< Basic blocks built at load time (empty if blocks are off)
+    size_t runs = 0;                    ///< Requests that execute program now
+    int replaced = 0;                   ///< Program was replaced by load with the same name
+} ServerProgram;
+
+
+/// Server state shared by all workers
+typedef struct {
+    int socket = -1;                                ///< Listening socket
+    const Program *settings = nullptr;              ///< Execution settings from command line
+    size_t ram_size = 0;                            ///< RAM size in cells (0 means size from binary file)
+    unsigned int screen_width = SCREEN_WIDTH;       ///< Screen width for SHOW
+    unsigned int screen_height = SCREEN_HEIGHT;     ///< Screen height for SHOW
+    Monitor monitor = {};                           ///< Protects programs
+    ServerProgram *programs[SERVER_PROGRAMS] = {};  ///< Loaded programs (nullptr for free slots)
+    int stop = 0;                                   ///< Stop request was received
+} Server;
+
+
+#ifdef __linux__
+
+/**
+ * \brief Reads request line without reading data after it
+ * \param [in]  client Client socket
+ * \param [out] line Buffer of SERVER_LINE bytes
+ * \return Non zero value means error or too long line
+*/
+static int server_line(int client, char *line) {
+    for(size_t i = 0; i < SERVER_LINE; i++) {
+        if (read(client, line + i, 1) != 1) return 1;
+
+        if (line[i] == '\n') {
+            line[i] = '\0';
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+/**
+ * \brief Skips unread client data and closes socket (closing it with unread data resets connection and drops reply)
+ * \param [in] client Client socket
+*/
+static void server_close(int client) {
+    char buffer[256] = "";
+
+    shutdown(client, SHUT_WR);
+
+    while (read(client, buffer, sizeof(buffer)) > 0) {}
+
+    close(client);
+}
+
+
+/**
+ * \brief Calculates FNV-1a hash of program code and format
+ * \param [in] program Loaded program
+ * \return Hash
+*/
+static unsigned long long server_hash(const Program *program) {
+    unsigned long long hash = 14695981039346656037ull;
+
+    const cmd_t *code = program -> code;
+
+    for(size_t i = 0; i < program -> count; i++)
+        hash = (hash ^ code[i]) * 1099511628211ull;
+
+    hash = (hash ^ (unsigned long long) program -> cell) * 1099511628211ull;
+    hash = (hash ^ (unsigned long long) program -> fixed.precision) * 1099511628211ull;
+    hash = (hash ^ program -> ram_size) * 1099511628211ull;
+
+    return hash;
+}
+
+
+/**
+ * \brief Builds basic blocks of loaded program
+ * \param [in]  program Loaded program
+ * \param [out] blockcode Blocks
+ * \return Non zero value means error
+*/
+template <typename Policy>
+static int server_blocks(const Program *program, BlockCode *blockcode) {
+    Process<Policy> process = {};
+
+    process.code = program -> code;
+    process.count = program -> count;
+
+    return blocks_build(&process, blockcode);
+}
+
+
+/**
+ * \brief Frees loaded program
+ * \param [in] entry Program to free
+*/
+static void server_free(ServerProgram *entry) {
+    free(entry -> program.code);
+    blocks_free(&entry -> blockcode);
+    free(entry);
+}
+
+
+/**
+ * \brief Finds program by name or by hash written in hex
+ * \param [in] server Server (monitor is locked)
+ * \param [in] name Name or hash
+ * \return Program or nullptr
+*/
+static ServerProgram *server_find(Server *server, const char *name) {
+    char *end = nullptr;
+    unsigned long long hash = strtoull(name, &end, 16);
+    int is_hash = *name && !*end;
+
+    for(size_t i = 0; i < SERVER_PROGRAMS; i++) {
+        ServerProgram *entry = server -> programs[i];
+
+        if (entry && (!strcmp(entry -> name, name) || (is_hash && entry -> hash == hash)))
+            return entry;
+    }
+
+    return nullptr;
+}
+
+
+/**
+ * \brief Reads binary file from client and replaces program with the same name
+ * \param [in] server Server
+ * \param [in] client Client socket
+ * \param [in] name Program name
+ * \return Non zero value means error
+*/
+static int server_load(Server *server, int client, const char *name) {
+    ServerProgram *entry = (ServerProgram *) calloc(1, sizeof(ServerProgram));
+
+    ASSERT(entry, "Can't allocate program!");
+
+    *entry = {};
+
+    strncpy(entry -> name, name, SERVER_LINE - 1);
+
+    entry -> program = *server -> settings;
+
+    if (read_file(client, &entry -> program) || (!server -> ram_size && !entry -> program.ram_size)) {
+        dprintf(client, "error invalid binary file\n");
+        server_free(entry);
+        return 1;
+    }
+
+    if (server -> ram_size)
+        entry -> program.ram_size = server -> ram_size;
+
+    entry -> hash = server_hash(&entry -> program);
+
+    if (entry -> program.blocks && !entry -> program.regvm) {
+        int error = 0;
+
+        switch (entry -> program.cell) {
+            case CELL_FIXED32: error = server_blocks<Fixed32Policy>(&entry -> program, &entry -> blockcode); break;
+            case CELL_FIXED64: error = server_blocks<Fixed64Policy>(&entry -> program, &entry -> blockcode); break;
+            default:           error = server_blocks<DoublePolicy>(&entry -> program, &entry -> blockcode);  break;
+        }
+
+        if (!error)
+            entry -> program.blockcode = &entry -> blockcode;
+    }
+
+    unsigned long long hash = entry -> hash;
+
+    fprintf(stderr, "Loaded %s (%016llx), %zu bytes\n", name, hash, entry -> program.count);
+
+    monitor_lock(&server -> monitor);
+
+    ServerProgram **slot = nullptr;
+
+    for(size_t i = 0; i < SERVER_PROGRAMS; i++) {
+        ServerProgram *old = server -> programs[i];
+
+        if (old && !strcmp(old -> name, name)) {
+            slot = server -> programs + i;
+            break;
+        }
+
+        if (!old && !slot)
+            slot = server -> programs + i;
+    }
+
+    if (slot && *slot) {
+        if ((*slot) -> runs)
+            (*slot) -> replaced = 1;
+        else
+            server_free(*slot);
+    }
+
+    if (slot)
+        *slot = entry;
+
+    monitor_unlock(&server -> monitor);
+
+    if (!slot) {
+        dprintf(client, "error too many programs\n");
+        server_free(entry);
+        return 1;
+    }
+
+    dprintf(client, "ok %016llx\n", hash);
+
+    return 0;
+}
+
+
+/**
+ * \brief Executes loaded program with client as input, output and screen
+ * \param [in] server Server
+ * \param [in] client Client socket (closed on return)
+ * \param [in] name Program name or hash
+ * \param arena RAM of the previous run of this worker
+ * \return Non zero value means error
+*/
+static int server_run(Server *server, int client, const char *name, Arena *arena) {
+    monitor_lock(&server -> monitor);
+
+    ServerProgram *entry = server_find(server, name);
+
+    if (entry)
+        entry -> runs++;
+
+    monitor_unlock(&server -> monitor);
+
+    if (!entry) {
+        dprintf(client, "error unknown program %s\n", name);
+        server_close(client);
+        return 1;
+    }
+
+    Program program = entry -> program;
+
+    // Channels close client socket, so status of failed run is written through copy after program output
+    int status = dup(client);
+
+    IoChannel io[IO_CHANNELS] = {};
+    Screen screen = {};
+
+    int bound = !io_open_input(io, client, IO_TEXT);
+
+    int error = !bound || io_open_output(io, dup(client), IO_TEXT) ||
+                screen_constructor(&screen, server -> screen_width, server -> screen_height, client);
+
+    program.io = io;
+    program.screen = &screen;
+    program.arena = arena;
+
+    if (!error) {
+        switch (program.cell) {
+            case CELL_FIXED32: error = run_program<Fixed32Policy>(&program); break;
+            case CELL_FIXED64: error = run_program<Fixed64Policy>(&program); break;
+            default:           error = run_program<DoublePolicy>(&program);  break;
+        }
+    }
+
+    screen_destructor(&screen);
+
+    for(int i = 0; i < IO_CHANNELS; i++)
+        io_close(io + i);
+
+    // Client socket is closed with channel input
+    if (!bound)
+        close(client);
+
+    if (status != -1) {
+        if (error || program.failed)
+            dprintf(status, "error execution failed\n");
+
+        close(status);
+    }
+
+    monitor_lock(&server -> monitor);
+
+    entry -> runs--;
+
+    if (entry -> replaced && !entry -> runs)
+        server_free(entry);
+
+    monitor_unlock(&server -> monitor);
+
+    return error;
+}
+
+
+/**
+ * \brief Accepts clients and executes their requests until stop request
+ * \param [in] arg Server
+*/
+static void server_worker(void *arg) {
+    Server *server = (Server *) arg;
+
+    char line[SERVER_LINE] = "";
+
+    // Requests of one worker are executed one by one, so they reuse RAM
+    Arena arena = {};
+
+    while (!__atomic_load_n(&server -> stop, __ATOMIC_SEQ_CST)) {
+        int client = accept(server -> socket, nullptr, nullptr);
+
+        if (client == -1) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (server_line(client, line)) {
+            dprintf(client, "error invalid request\n");
+            server_close(client);
+        }
+        else if (!strncmp(line, "load ", 5) && line[5]) {
+            server_load(server, client, line + 5);
+            server_close(client);
+        }
+        else if (!strncmp(line, "run ", 4) && line[4]) {
+            server_run(server, client, line + 4, &arena);
+        }
+        else if (!strcmp(line, "stop")) {
+            __atomic_store_n(&server -> stop, 1, __ATOMIC_SEQ_CST);
+            dprintf(client, "ok\n");
+            server_close(client);
+
+            shutdown(server -> socket, SHUT_RDWR);
+        }
+        else {
+            dprintf(client, "error unknown request %s\n", line);
+            server_close(client);
+        }
+    }
+
+    arena_destructor(&arena);
+}
+
+
+int server_main(const char *path, const Program *settings, size_t ram_size, size_t workers, unsigned int screen_width, unsigned int screen_height) {
+    ASSERT(path && settings, "Can't work with then null pointer!");
+
+    struct sockaddr_un address = {};
+
+    address.sun_family = AF_UNIX;
+
+    ASSERT(strlen(path) < sizeof(address.sun_path), "Socket path is too long!");
+
+    strcpy(address.sun_path, path);
+
+    Server server = {};
+
+    server.settings = settings;
+    server.ram_size = ram_size;
+    server.screen_width = screen_width;
+    server.screen_height = screen_height;
+
+    ASSERT(!monitor_constructor(&server.monitor), "Can't create server monitor!");
+
+    server.socket = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    ASSERT(server.socket != -1, "Can't create socket!");
+
+    unlink(path);
+
+    if (bind(server.socket, (const struct sockaddr *) &address, sizeof(address)) || listen(server.socket, SERVER_BACKLOG)) {
+        printf("Can't listen %s!\n", path);
+        close(server.socket);
+        monitor_destructor(&server.monitor);
+        return 1;
+    }
+
+    // Client can close socket before output is written
+    signal(SIGPIPE, SIG_IGN);
+
+    Thread *threads = (Thread *) calloc(workers, sizeof(Thread));
+
+    ASSERT(threads, "Can't allocate server workers!");
+
+    size_t started = 0;
+
+    for(; started < workers; started++)
+        if (thread_start(threads + started, server_worker, &server)) break;
+
+    fprintf(stderr, "Server: %s, %zu workers\n", path, started);
+
+    for(size_t i = 0; i < started; i++)
+        thread_join(threads + i);
+
+    free(threads);
+
+    for(size_t i = 0; i < SERVER_PROGRAMS; i++)
+        if (server.programs[i])
+            server_free(server.programs[i]);
+
+    close(server.socket);
+    unlink(path);
+
+    monitor_destructor(&server.monitor);
+
+    return started == 0;
+}
+
+#else
+
+int server_main(const char *path, const Program *settings, size_t ram_size, size_t workers, unsigned int screen_width, unsigned int screen_height) {
+    (void) path; (void) settings; (void) ram_size; (void) workers; (void) screen_width; (void) screen_height;
+
+    printf("Server mode is not supported on this system!\n");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,245 @@
+/**
+ * \file
+ * \brief Process snapshots: SNAPSHOT writes process state to file, --restore continues process from it
+ * \note File contains header, code, registers, both stacks and RAM aligned to SNAPSHOT_ALIGN, zero RAM pages are left as holes
+ * \note Include it after Process and read_full()
+*/
+
+
+/// Snapshot file signature
+const char *SNAPSHOT_SIGN = "AT-ST";
+
+/// RAM offset alignment in snapshot file (multiple of page size on all systems, so RAM can be mapped)
+const size_t SNAPSHOT_ALIGN = 1 << 16;
+
+
+/// Snapshot file header
+typedef struct {
+    char sign[8] = "";      ///< SNAPSHOT_SIGN
+    int version = 0;        ///< VERSION of code
+    int cell = 0;           ///< One of CELL_TYPE
+    int precision = 0;      ///< Fixed point precision
+    size_t count = 0;       ///< Code size
+    size_t ram_size = 0;    ///< RAM size in cells
+    size_t ip = 0;          ///< Offset of the command after SNAPSHOT
+    size_t value_size = 0;  ///< Value stack size
+    size_t call_size = 0;   ///< Call stack size
+    size_t ram_offset = 0;  ///< RAM offset in file
+} SnapshotHeader;
+
+
+/**
+ * \brief Writes data to file until all bytes are written
+ * \param [in] file Output file
+ * \param [in] data Data
+ * \param [in] size Bytes to write
+ * \return Non zero value means error
+*/
+static int snapshot_put(int file, const void *data, size_t size) {
+    for(size_t done = 0; done < size;) {
+        ssize_t bytes = write(file, (const char *) data + done, (unsigned int)(size - done));
+
+        if (bytes <= 0) return 1;
+
+        done += (size_t) bytes;
+    }
+
+    return 0;
+}
+
+
+/**
+ * \brief Sets file size
+ * \param [in] file File
+ * \param [in] size New size
+ * \return Non zero value means error
+*/
+static int snapshot_resize(int file, size_t size) {
+#if defined(_WIN32) || defined(_WIN64)
+    return _chsize_s(file, (long long) size) != 0;
+#else
+    return ftruncate(file, (off_t) size) != 0;
+#endif
+}
+
+
+/**
+ * \brief Writes process state to process snapshot file (replaces previous snapshot)
+ * \param [in] process Process that executes SNAPSHOT
+ * \param [in] reg Registers
+ * \param [in] ip Command to continue from
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int snapshot_write(const Process<Policy> *process, const typename Policy::cell_t *reg, const cmd_t *ip) {
+    typedef typename Policy::cell_t cell_t;
+
+    int file = process -> snapshot;
+
+    ASSERT(file != -1, "Snapshot file is not set!");
+
+    // Free lists live in thread caches and outside RAM, so they can't be restored
+    ASSERT(!process -> heap || !process -> heap -> top, "Snapshot of process with heap blocks is not supported!");
+
+    SnapshotHeader header = {};
+
+    strncpy(header.sign, SNAPSHOT_SIGN, sizeof(header.sign) - 1);
+
+    header.version = VERSION;
+    header.cell = Policy::CELL;
+    header.precision = process -> fixed.precision;
+    header.count = process -> count;
+    header.ram_size = process -> ram_size;
+    header.ip = (size_t)(ip - process -> code);
+    header.value_size = (size_t) process -> value_stack.size;
+    header.call_size = (size_t) process -> call_stack.size;
+
+    size_t data = sizeof(header) + header.count * sizeof(cmd_t) + (REGISTER_SIZE + header.value_size) * sizeof(cell_t) + header.call_size * sizeof(int);
+
+    header.ram_offset = (data + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN;
+
+    size_t ram_bytes = header.ram_size * sizeof(cell_t);
+
+    if (snapshot_resize(file, 0) || lseek(file, 0, SEEK_SET) != 0) return 1;
+
+    if (snapshot_put(file, &header, sizeof(header)) ||
+        snapshot_put(file, process -> code, header.count * sizeof(cmd_t)) ||
+        snapshot_put(file, reg, REGISTER_SIZE * sizeof(cell_t)) ||
+        snapshot_put(file, process -> value_stack.data, header.value_size * sizeof(cell_t)) ||
+        snapshot_put(file, process -> call_stack.data, header.call_size * sizeof(int)))
+        return 1;
+
+    // Untouched RAM is zero, zero pages are skipped so file stays sparse
+    const char *ram = (const char *) process -> ram;
+
+    for(size_t page = 0; page < ram_bytes; page += SNAPSHOT_ALIGN) {
+        size_t size = (ram_bytes - page < SNAPSHOT_ALIGN) ? ram_bytes - page : SNAPSHOT_ALIGN;
+
+        size_t i = 0;
+        while (i < size && !ram[page + i]) i++;
+
+        if (i == size) continue;
+
+        if (lseek(file, (off_t)(header.ram_offset + page), SEEK_SET) == -1 || snapshot_put(file, ram + page, size))
+            return 1;
+    }
+
+    return snapshot_resize(file, header.ram_offset + ram_bytes);
+}
+
+
+int same_file(int first, int second) {
+    struct stat first_info = {}, second_info = {};
+
+    if (second == -1 || fstat(first, &first_info) || fstat(second, &second_info)) return 0;
+
+    return first_info.st_dev == second_info.st_dev && first_info.st_ino == second_info.st_ino;
+}
+
+
+/**
+ * \brief Reads program code and format from snapshot
+ * \param [in]  file Snapshot file
+ * \param [out] program Program to read in (if it already has code, code must be the same)
+ * \return Non zero value means error
+*/
+int snapshot_load(int file, Program *program) {
+    ASSERT(file > -1 && program, "Invalid snapshot file!");
+
+    SnapshotHeader header = {};
+
+    ASSERT(read_full(file, &header, sizeof(header)) == sizeof(header), "Can't read snapshot header!");
+
+    ASSERT(!strncmp(header.sign, SNAPSHOT_SIGN, sizeof(header.sign)), "Signature of snapshot doesn't match!");
+    ASSERT(header.version == VERSION, "Version of snapshot doesn't match!");
+    ASSERT(header.cell >= CELL_FIXED32 && header.cell <= CELL_DOUBLE, "Invalid cell type in snapshot!");
+    ASSERT(header.ip <= header.count && header.ram_size, "Invalid snapshot!");
+
+    cmd_t *code = (cmd_t *) calloc(header.count + 1, sizeof(cmd_t));
+
+    ASSERT(code, "Can't allocate code!");
+
+    if (read_full(file, code, header.count * sizeof(cmd_t)) != header.count * sizeof(cmd_t)) {
+        free(code);
+        ASSERT(0, "Can't read snapshot code!");
+    }
+
+    if (program -> code) {
+        int same = program -> count == header.count && program -> cell == header.cell && !memcmp(program -> code, code, header.count * sizeof(cmd_t));
+
+        free(code);
+
+        ASSERT(same, "Snapshot is made by other program!");
+    }
+    else {
+        program -> code = code;
+        program -> count = header.count;
+        program -> cell = header.cell;
+    }
+
+    ASSERT(!fixed_constructor(&program -> fixed, header.precision), "Invalid precision in snapshot!");
+
+    program -> ram_size = header.ram_size;
+    program -> restore = file;
+
+    return 0;
+}
+
+
+/**
+ * \brief Sets registers, stacks, RAM and ip of initialized process from snapshot
+ * \param process Process created by init_process()
+ * \param [in] file Snapshot file
+ * \note RAM is mapped as private copy of file where possible, so restored processes share untouched pages
+ * \return Non zero value means error
+*/
+template <typename Policy>
+int snapshot_restore(Process<Policy> *process, int file) {
+    typedef typename Policy::cell_t cell_t;
+
+    SnapshotHeader header = {};
+
+    ASSERT(lseek(file, 0, SEEK_SET) == 0 && read_full(file, &header, sizeof(header)) == sizeof(header), "Can't read snapshot header!");
+
+    ASSERT(header.ram_size <= process -> ram_size, "RAM is smaller than snapshot!");
+
+    ASSERT(lseek(file, (off_t)(header.count * sizeof(cmd_t)), SEEK_CUR) != -1, "Can't read snapshot!");
+
+    ASSERT(read_full(file, process -> reg, REGISTER_SIZE * sizeof(cell_t)) == REGISTER_SIZE * sizeof(cell_t), "Can't read snapshot registers!");
+
+    for(size_t i = 0; i < header.value_size; i++) {
+        cell_t value = 0;
+
+        ASSERT(read_full(file, &value, sizeof(value)) == sizeof(value), "Can't read snapshot value stack!");
+        ASSERT(!stack_push(&process -> value_stack, value), "Stack push error!");
+    }
+
+    for(size_t i = 0; i < header.call_size; i++) {
+        int value = 0;
+
+        ASSERT(read_full(file, &value, sizeof(value)) == sizeof(value), "Can't read snapshot call stack!");
+        ASSERT(!stack_push(&process -> call_stack, value), "Stack push error!");
+    }
+
+    size_t ram_bytes = header.ram_size * sizeof(cell_t);
+
+#ifdef MAP_FAILED
+    // RAM followed by guard pages is not aligned to page, so it is read
+    if ((size_t) process -> ram % memory_page_size() == 0) {
+        void *ram = mmap(process -> ram, ram_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, file, (off_t) header.ram_offset);
+
+        ASSERT(ram != MAP_FAILED, "Can't map snapshot RAM!");
+
+        process -> ip = process -> code + header.ip;
+
+        return 0;
+    }
+#endif
+
+    ASSERT(lseek(file, (off_t) header.ram_offset, SEEK_SET) != -1, "Can't read snapshot RAM!");
+    ASSERT(read_full(file, process -> ram, ram_bytes) == ram_bytes, "Can't read snapshot RAM!");
+
+    process -> ip = process -> code + header.ip;
+
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <stdio.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <io.h>
+#elif __linux__
+    #define O_BINARY 0
+
+    #include <unistd.h>
+#else
+    #error "Your system case is not defined!"
+#endif
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libs/parser.hpp"
+#include "libs/trace.hpp"
+#include "console/trc_func_list.hpp"
+#include "command.hpp"
+#include "assert.hpp"
+
+
+#define DEF_CMD(name, ...) #name,
+
+/// Command names by their codes
+const char *CMD_NAMES[] = {
+    #include "cmd.hpp"
+};
+
+#undef DEF_CMD
+
+
+/**
+ * \brief Reads one trace dump and prints it
+ * \param [in] file Trace file
+ * \param [in] stream Output file
+ * \return 1 on error, -1 on end of file, 0 otherwise
+*/
+int print_dump(int file, FILE *stream);
+
+
+/**
+ * \brief Prints one trace record
+ * \param [in] record Record to print
+ * \param [in] index Record index since process start
+ * \param [in] precision Fixed point precision
+ * \param [in] stream Output file
+*/
+void print_record(const TraceRecord *record, size_t index, int precision, FILE *stream);
+
+
+
+
+int main(int argc, char *argv[]) {
+    int input = -1;
+
+    #include "console/trc_cmd_list.hpp"
+
+    if (parse_args(argc, argv, command_list, sizeof(command_list) / sizeof(Command)))
+        return 1;
+
+    if (input == -1)
+        return 1;
+
+    int error = 0;
+
+    while (!(error = print_dump(input, stdout)))
+        putchar('\n');
+
+    close(input);
+
+    return error == 1;
+}
+
+
+int print_dump(int file, FILE *stream) {
+    ASSERT(file > -1, "Invalid file!");
+
+    char sig[sizeof(TRACE_SIGN)] = "";
+
+    size_t bytes = read(file, sig, sizeof(TRACE_SIGN));
+
+    if (bytes == 0) return -1;
+
+    ASSERT(bytes == sizeof(TRACE_SIGN) && !strncmp(sig, TRACE_SIGN, sizeof(TRACE_SIGN)), "Signature of trace doesn't match!");
+
+    int ver = 0, precision = 0;
+    size_t count = 0, size = 0;
+
+    bytes += read(file, &ver, sizeof(int));
+
+    ASSERT(ver == TRACE_VERSION, "Version of trace doesn't match!");
+
+    bytes += read(file, &precision, sizeof(int));
+
+    bytes += read(file, &count, sizeof(size_t));
+    bytes += read(file, &size, sizeof(size_t));
+
+    ASSERT(bytes == sizeof(TRACE_SIGN) + 2 * sizeof(int) + 2 * sizeof(size_t), "Trace header is too short!");
+
+    ASSERT(precision > 0, "Invalid precision in trace!");
+
+    TraceRecord *records = (TraceRecord *) calloc(size, sizeof(TraceRecord));
+
+    ASSERT(records || !size, "Can't allocate trace records!");
+
+    bytes = read(file, records, size * sizeof(TraceRecord));
+
+    if (bytes != size * sizeof(TraceRecord)) {
+        printf("Expected bytes %zu, actualy read %zu\n", size * sizeof(TraceRecord), bytes);
+        free(records);
+        return 1;
+    }
+
+    fprintf(stream, "Executed %zu instructions, last %zu recorded\n", count, size);
+    fprintf(stream, "%-10s %-6s %-4s %-12s %s\n", "#", "IP", "CMD", "NAME", "TOP");
+
+    for(size_t i = 0; i < size; i++)
+        print_record(records + i, count - size + i, precision, stream);
+
+    free(records);
+
+    return 0;
+}
+
+
+void print_record(const TraceRecord *record, size_t index, int precision, FILE *stream) {
+    unsigned int code = record -> code;
+
+    char name[16] = "";
+
+    snprintf(name, sizeof(name), "%s%s%s%s",
+        (code < sizeof(CMD_NAMES) / sizeof(*CMD_NAMES)) ? CMD_NAMES[code] : "???",
+        (record -> flags & BIT_MEM)   ? " M" : "",
+        (record -> flags & BIT_REG)   ? " R" : "",
+        (record -> flags & BIT_CONST) ? " C" : "");
+
+    fprintf(stream, "%-10zu %06u %04X %-12s %g\n", index, record -> offset, code | record -> flags, name, (float) record -> top / (float) precision);
+}
@@ -0,0 +1,256 @@
+#include <stdio.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <io.h>
+#elif __linux__
+    #define O_BINARY 0
+
+    #include <unistd.h>
+#else
+    #error "Your system case is not defined!"
+#endif
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include "libs/parser.hpp"
+#include "console/aot_func_list.hpp"
+#include "command.hpp"
+#include "decode.hpp"
+#include "assert.hpp"
+
+
+#define DEF_CMD(name, ...) #name,
+
+/// Command names by their codes
+const char *CMD_NAMES[] = {
+    #include "cmd.hpp"
+};
+
+#undef DEF_CMD
+
+
+/// Processor specializations by cell type
+const char *CELL_POLICIES[] = {"Fixed32Policy", "Fixed64Policy", "DoublePolicy"};
+
+
+/// Binary file to translate
+typedef struct {
+    cmd_t *code = nullptr;  ///< Operation code
+    size_t count = 0;       ///< Operation count
+    size_t ram_size = 0;    ///< RAM size in cells
+    int precision = 0;      ///< Fixed point precision
+    int cell = 0;           ///< One of CELL_TYPE
+} Program;
+
+
+/**
+ * \brief Reads binary file
+ * \param [in]  file Input file
+ * \param [out] program Program to read in
+ * \return Non zero value means error
+*/
+int read_file(int file, Program *program);
+
+
+/**
+ * \brief Writes program as C++ function with label for every basic block
+ * \param [in] program Program to translate
+ * \param [in] stream Output file
+ * \return Non zero value means error
+*/
+int translate(const Program *program, FILE *stream);
+
+
+/**
+ * \brief Writes one command as constant switch over cmd.hpp handlers
+ * \param [in] program Translated program
+ * \param [in] offset Command offset
+ * \param [in] marks Block and command starts
+ * \param [in] stream Output file
+ * \return Offset of the next command
+*/
+size_t translate_command(const Program *program, size_t offset, const cmd_t *marks, FILE *stream);
+
+
+
+
+int main(int argc, char *argv[]) {
+    int input = -1, output = -1;
+
+    #include "console/aot_cmd_list.hpp"
+
+    if (parse_args(argc, argv, command_list, sizeof(command_list) / sizeof(Command)))
+        return 1;
+
+    if (input == -1 || output == -1)
+        return 1;
+
+    Program program = {};
+
+    if (read_file(input, &program))
+        return 1;
+
+    close(input);
+
+    FILE *stream = fdopen(output, "w");
+
+    ASSERT(stream, "Can't open output file!");
+
+    int error = translate(&program, stream);
+
+    fclose(stream);
+
+    free(program.code);
+
+    if (error)
+        return 1;
+
+    printf("Translator!\n");
+
+    return 0;
+}
+
+
+int read_file(int file, Program *program) {
+    ASSERT(file > -1, "Invalid file!");
+    ASSERT(program, "Can't work with then null pointer!");
+
+    char *sig = (char *) calloc(strlen(SIGN) + 1, sizeof(char));
+
+    ASSERT(sig, "Can't allocate signature!");
+
+    size_t bytes = read(file, sig, strlen(SIGN) + 1);
+
+    ASSERT(!strncmp(sig, SIGN, strlen(SIGN) + 1), "Signature of file doesn't match!");
+
+    free(sig);
+
+    int ver = 0;
+
+    bytes += read(file, &ver, sizeof(int));
+
+    ASSERT(ver == VERSION, "Version of file doesn't match!");
+
+    bytes += read(file, &(program -> count), sizeof(size_t));
+    bytes += read(file, &(program -> ram_size), sizeof(size_t));
+    bytes += read(file, &(program -> precision), sizeof(int));
+    bytes += read(file, &(program -> cell), sizeof(int));
+
+    ASSERT(program -> cell >= CELL_FIXED32 && program -> cell <= CELL_DOUBLE, "Invalid cell type in file!");
+
+    program -> code = (cmd_t *) calloc(program -> count + 1, sizeof(cmd_t));
+
+    ASSERT(program -> code, "Can't allocate code!");
+
+    bytes += read(file, program -> code, (unsigned int)(program -> count * sizeof(cmd_t)));
+
+    size_t expected_bytes = strlen(SIGN) + 1 + 3 * sizeof(int) + 2 * sizeof(size_t) + program -> count * sizeof(cmd_t);
+
+    if (bytes != expected_bytes) {
+        printf("Expected bytes %zu, actualy read %zu\n", expected_bytes, bytes);
+        return 1;
+    }
+
+    return 0;
+}
+
+
+int translate(const Program *program, FILE *stream) {
+    ASSERT(program && stream, "Can't work with then null pointer!");
+
+    cmd_t *marks = (cmd_t *) calloc(program -> count + 1, sizeof(cmd_t));
+
+    ASSERT(marks, "Can't allocate block marks!");
+
+    if (program -> cell == CELL_FIXED32)
+        blocks_mark<int>(program -> code, program -> count, marks);
+    else
+        blocks_mark<long long>(program -> code, program -> count, marks);
+
+    const char *policy = CELL_POLICIES[program -> cell];
+
+    fprintf(stream, "/**\n * \\file\n * \\brief Program translated by aot.exe (build it with make native)\n*/\n\n\n");
+
+    fprintf(stream, "/// Translated code (process runs on it, so compiler folds arguments that handlers read)\nstatic const cmd_t AOT_CODE[] = {");
+
+    for(size_t i = 0; i < program -> count; i++)
+        fprintf(stream, "%s0x%02X,", (i % 16) ? " " : "\n    ", program -> code[i]);
+
+    fprintf(stream, "\n};\n\n");
+
+    fprintf(stream, "/// RAM size in cells\nconst size_t AOT_RAM_SIZE = %zu;\n\n", program -> ram_size);
+    fprintf(stream, "/// Fixed point precision\nconst int AOT_PRECISION = %i;\n\n", program -> precision);
+    fprintf(stream, "/// One of CELL_TYPE\nconst int AOT_CELL = %i;\n\n\n", program -> cell);
+
+    fprintf(stream, "int aot_execute(Process<%s> *process);\n\n\n", policy);
+
+    fprintf(stream, "int aot_execute(Process<%s> *process) {\n", policy);
+    fprintf(stream, "    typedef %s Policy;\n    typedef Policy::cell_t cell_t;\n\n", policy);
+    fprintf(stream, "    /// SHORTCUTS ///\n    const cmd_t *ip = process -> ip;\n    cmd_t cmd = 0;\n\n");
+    fprintf(stream, "    Stack<cell_t> *stack = &(process -> value_stack);\n    Stack<int> *call_stack = &(process -> call_stack);\n\n");
+    fprintf(stream, "    cell_t *reg = process -> reg;\n    cell_t *ram = process -> ram;\n\n");
+    fprintf(stream, "    const Fixed *fixed = &(process -> fixed);\n\n");
+    fprintf(stream, "    if (ip != process -> code) goto dispatch;\n\n");
+
+    for(size_t offset = 0; offset < program -> count;)
+        offset = translate_command(program, offset, marks, stream);
+
+    fprintf(stream, "    goto dispatch;\n\n    dispatch:\n    switch (OFFSET(ip)) {\n");
+
+    for(size_t offset = 0; offset < program -> count; offset++) {
+        if ((marks[offset] & MARK_BLOCK) && (marks[offset] & MARK_COMMAND))
+            fprintf(stream, "        case %zu: goto L_%zu;\n", offset, offset);
+    }
+
+    fprintf(stream, "        default: break;\n    }\n\n");
+    fprintf(stream, "    ASSERT_IP((size_t)(OFFSET(ip)) >= process -> count, \"Jump to the middle of command!\", (size_t)(OFFSET(ip)));\n\n");
+    fprintf(stream, "    printf(\"[Warning] No hlt at end of the process!\\n\");\n    return 0;\n}\n");
+
+    free(marks);
+
+    return 0;
+}
+
+
+size_t translate_command(const Program *program, size_t offset, const cmd_t *marks, FILE *stream) {
+    const cmd_t *code = program -> code;
+
+    cmd_t cmd = code[offset];
+    unsigned int command = cmd & CMD_MASK;
+    size_t args = offset + 1;
+
+    if (command == CMD_EXT)
+        command += code[args++];
+
+    size_t next = args + ((program -> cell == CELL_FIXED32) ?
+        command_args_size<int>(command, (cmd_t)(cmd & ~CMD_MASK)) :
+        command_args_size<long long>(command, (cmd_t)(cmd & ~CMD_MASK)));
+
+    const char *name = (command < sizeof(CMD_NAMES) / sizeof(*CMD_NAMES)) ? CMD_NAMES[command] : nullptr;
+
+    if (marks[offset] & MARK_BLOCK)
+        fprintf(stream, "\n    L_%zu:\n", offset);
+
+    if (!name) {
+        fprintf(stream, "    printf(\"Unknown command %u in operation %zu!\\n\");\n    return 1;\n", command, offset);
+        return next;
+    }
+
+    fprintf(stream, "    ip = AOT_CODE + %zu;\n    cmd = 0x%02X;\n", args, cmd);
+    fprintf(stream, "    switch ((unsigned int) CMD_%s) {\n        #include \"cmd.hpp\"\n        default: break;\n    }\n", name);
+
+    if (command == CMD_RET) {
+        fprintf(stream, "    goto dispatch;\n");
+    }
+    else if (command_is_jump(command) && next <= program -> count) {
+        arg_t target = *((const arg_t *)(code + next - sizeof(arg_t)));
+
+        if (target > -1 && (size_t) target < program -> count && (marks[target] & MARK_COMMAND))
+            fprintf(stream, "    if (ip == AOT_CODE + %i) goto L_%i;\n", target, target);
+        else
+            fprintf(stream, "    if (ip != AOT_CODE + %zu) goto dispatch;\n", next);
+    }
+
+    return next;
+}